@@ -0,0 +1,99 @@
+/* On-target micro-benchmarks of the EwUtil hot paths
+ *
+ * Benchmark.ino
+ *
+ *  Created on: Oct 14, 2026
+ *
+ * Prints the average number of CPU cycles per call. On AVR the cycles are
+ * counted by Timer1 running without prescaler, on the ESP8266/ESP32 and
+ * Cortex-M3/M4/M7 by the cycle counter, elsewhere microseconds are
+ * printed instead. Compare the numbers between library versions to catch
+ * regressions, see extras/host for the host counterpart.
+ */
+
+#include <EwFmt.h>
+#include <EwStreamFmt.h>
+
+#if defined(__AVR__)
+typedef uint16_t Cycles;
+static void beginCycles() { TCCR1A = 0; TCCR1B = _BV(CS10); }
+static Cycles cycles()    { return TCNT1; }
+static const char *Unit = "cycles";
+#elif defined(ESP8266) || defined(ESP32) || defined(__ARM_ARCH_7M__) || defined(__ARM_ARCH_7EM__)
+typedef unsigned long Cycles;
+static void beginCycles()
+{
+# if defined(__ARM_ARCH_7M__) || defined(__ARM_ARCH_7EM__)
+  ew::CycleClock::begin();
+# endif
+}
+static Cycles cycles()    { return ew::CycleClock::now(); }
+static const char *Unit = "cycles";
+#else
+typedef unsigned long Cycles;
+static void beginCycles() {}
+static Cycles cycles()    { return micros(); }
+static const char *Unit = "us";
+#endif
+
+/** Print discarding everything */
+class NullPrint
+  : public Print
+{
+public:
+  size_t write(uint8_t) override { return 1; }
+  size_t write(const uint8_t *, size_t len) override { return len; }
+  using Print::write;
+};
+
+static NullPrint out;
+static volatile unsigned long sink;
+
+/* Every call is timed on its own so the 16-bit AVR counter can't wrap */
+template <class Fn>
+static void
+bench(const __FlashStringHelper *name, unsigned int iterations, Fn &&fn)
+{
+  unsigned long total = 0;
+  for (unsigned int i = 0; i < iterations; i++) {
+    Cycles start = cycles();
+    fn();
+    total += static_cast<Cycles>(cycles() - start);
+  }
+  using namespace ew;
+  Serial << name << F(": ") << total / iterations << ' ' << Unit << "\r\n";
+}
+
+struct Task : PeriodicalBase<Task>
+{
+  Task() : PeriodicalBase<Task>(10) {}
+  void task() { sink++; }
+};
+
+static InlinePeriodical<> periodical(10, [] { sink++; });
+static Task task;
+static Timer timer(10, Timer::Periodic);
+static ew::FixedString<32> str;
+
+void setup()
+{
+  Serial.begin(115200);
+  beginCycles();
+  timer.start();
+}
+
+void loop()
+{
+  const unsigned int n = 1000;
+  bench(F("Periodical::run()"), n, [] { periodical.run(); });
+  bench(F("PeriodicalBase<T>::run()"), n, [] { task.run(); });
+  bench(F("Timer::expired()"), n, [] { sink += timer.expired(); });
+  bench(F("prtFmt<16>(Print)"), n, [] { ew::prtFmt<16>(out, "t=%d %s", 1234, "ok"); });
+  bench(F("prtFmt<64>(Print)"), n, [] { ew::prtFmt<64>(out, "t=%d %s", 1234, "ok"); });
+  bench(F("streamFmt(Print)"), n, [] { ew::streamFmt(out, "t=%d %s", 1234, "ok"); });
+  bench(F("EW_PRT_FMT(Print)"), n, [] { EW_PRT_FMT(out, "t=%d %s", 1234, "ok"); });
+  bench(F("fmtElapsed(FixedString)"), n, [] { ew::fmtElapsed(str, millis()); });
+  bench(F("prtElapsed(Print)"), n, [] { ew::prtElapsed(out, millis()); });
+  Serial.println();
+  delay(5000);
+}
@@ -0,0 +1,109 @@
+/* Host micro-benchmarks of the hot paths
+ *
+ * Bench.cpp
+ *
+ *  Created on: Oct 14, 2026
+ *
+ * Prints the average cost per call in nanoseconds. The mocked clock
+ * advances by a microsecond per call, so the periodicals and timers fire
+ * at their real rate, ew::Tick is sampled once per call like once per
+ * loop pass. Pass the number of iterations as first argument.
+ * See examples/Benchmark for the same measurements in cycles on target.
+ */
+
+#include <EwFmt.h>
+#include <EwStreamFmt.h>
+
+#include <chrono>
+#include <stdlib.h>
+
+namespace {
+
+volatile unsigned long sink;
+
+/** Keeps the compiler from hoisting clock reads out of the loop */
+inline void
+barrier()
+{
+  __asm__ volatile ("" ::: "memory");
+}
+
+template <class Fn>
+void
+bench(const char *name, unsigned long iterations, Fn &&fn)
+{
+  auto start = std::chrono::steady_clock::now();
+  for (unsigned long i = 0; i < iterations; i++) {
+    mock::advanceUs(1);
+    ew::Tick::update();
+    fn();
+    barrier();
+  }
+  std::chrono::duration<double, std::nano> ns = std::chrono::steady_clock::now() - start;
+  printf("%-36s %8.1f ns\n", name, ns.count() / iterations);
+}
+
+/** Print discarding everything */
+class NullPrint
+  : public Print
+{
+public:
+  size_t write(uint8_t) override { sink++; return 1; }
+  size_t write(const uint8_t *, size_t len) override { sink += len; return len; }
+  using Print::write;
+};
+
+struct Task : PeriodicalBase<Task>
+{
+  Task() : PeriodicalBase<Task>(10) {}
+  void task() { sink++; }
+};
+
+struct BlinkTimer : TimerBase<BlinkTimer, TimerModes::Periodic, 10>
+{
+  void onExpired() { sink++; }
+};
+
+} // namespace
+
+int
+main(int argc, char **argv)
+{
+  unsigned long n = argc > 1 ? strtoul(argv[1], nullptr, 0) : 10000000UL;
+  NullPrint out;
+
+  Periodical periodical(10, [] { sink++; });
+  bench("Periodical::run()", n, [&] { periodical.run(); });
+  InlinePeriodical<> inlinePeriodical(10, [] { sink++; });
+  bench("InlinePeriodical::run()", n, [&] { inlinePeriodical.run(); });
+  Task task;
+  bench("PeriodicalBase<T>::run()", n, [&] { task.run(); });
+
+  Timer timer(10, Timer::Periodic);
+  timer.start();
+  bench("Timer::expired()", n, [&] { sink += timer.expired(); });
+  bench("Timer::expired(now)", n, [&] { sink += timer.expired(ew::Tick::now()); });
+  BlinkTimer blink;
+  blink.start();
+  bench("TimerBase<T, Periodic, 10>::run()", n, [&] { blink.run(); });
+
+  n /= 10;
+  bench("prtFmt<16>(Print)", n, [&] { ew::prtFmt<16>(out, "t=%d %s", 1234, "ok"); });
+  bench("prtFmt<64>(Print)", n, [&] { ew::prtFmt<64>(out, "t=%d %s", 1234, "ok"); });
+  bench("prtFmt<256>(Print)", n, [&] { ew::prtFmt<256>(out, "t=%d %s", 1234, "ok"); });
+  bench("streamFmt(Print)", n, [&] { ew::streamFmt(out, "t=%d %s", 1234, "ok"); });
+  bench("EW_PRT_FMT(Print)", n, [&] { EW_PRT_FMT(out, "t=%d %s", 1234, "ok"); });
+  bench("operator<< chain", n, [&] {
+    using namespace ew;
+    out << "t=" << 1234 << ' ' << "ok";
+  });
+
+  ew::FixedString<32> str;
+  bench("fmtElapsed(FixedString)", n, [&] { ew::fmtElapsed(str, micros()); });
+  bench("fmtElapsed(FixedString, formats)", n, [&] {
+    ew::fmtElapsed(str, micros(), false, "%lus", "%lum %02lus", "%luh %02lum %02lus",
+                   "%lud %02luh %02lum %02lus");
+  });
+  bench("prtElapsed(Print)", n, [&] { ew::prtElapsed(out, micros()); });
+  return 0;
+}
@@ -0,0 +1,14 @@
+/* State of the host-side Arduino mock
+ *
+ * Arduino.cpp
+ *
+ *  Created on: Oct 14, 2026
+ */
+
+#include <Arduino.h>
+
+namespace mock {
+
+uint64_t us = 0;
+
+} // namespace mock
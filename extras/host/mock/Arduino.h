@@ -0,0 +1,148 @@
+/* Minimal host-side stand-in for the Arduino core, just enough to build
+ * and exercise EwUtil off-target
+ *
+ * Arduino.h
+ *
+ *  Created on: Oct 14, 2026
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+#include <limits.h>
+#include <string>
+
+/** The mocked clock, it only advances when told to. Note that unsigned
+ * long and therefore the ticks of the standard clocks are 64 bits wide on
+ * most hosts, rollover is best tested with a clock of 32-bit ticks.
+ */
+namespace mock {
+extern uint64_t us;
+inline void advanceUs(unsigned long d) { us += d; }
+inline void advanceMs(unsigned long d) { us += d * 1000ULL; }
+/** Sets the clock to m milliseconds since boot */
+inline void set(unsigned long m) { us = m * 1000ULL; }
+} // namespace mock
+
+inline unsigned long millis() { return mock::us / 1000ULL; }
+inline unsigned long micros() { return mock::us; }
+inline void delay(unsigned long d) { mock::advanceMs(d); }
+inline void yield() {}
+inline void noInterrupts() {}
+inline void interrupts() {}
+
+#define DEC 10
+#define HEX 16
+#define OCT 8
+#define BIN 2
+
+class __FlashStringHelper;
+#define PROGMEM
+#define PGM_P const char *
+#define PSTR(s) (s)
+#define F(s) (reinterpret_cast<const __FlashStringHelper *>(PSTR(s)))
+#define FPSTR(p) (reinterpret_cast<const __FlashStringHelper *>(p))
+#define pgm_read_byte(p) (*reinterpret_cast<const uint8_t *>(p))
+#define strlen_P strlen
+#define vsnprintf_P vsnprintf
+#define snprintf_P snprintf
+
+class String
+{
+public:
+  String(const char *s = "") : m_s(s ? s : "") {}
+  String &operator=(const char *s) { m_s = s ? s : ""; return *this; }
+  String &operator+=(const char *s) { m_s += s; return *this; }
+  String &operator+=(char c) { m_s += c; return *this; }
+  bool operator==(const char *s) const { return m_s == s; }
+  const char *c_str() const { return m_s.c_str(); }
+  unsigned int length() const { return m_s.size(); }
+private:
+  std::string m_s;
+};
+
+class Print
+{
+public:
+  virtual ~Print() {}
+  virtual size_t write(uint8_t c) = 0;
+  virtual size_t write(const uint8_t *buf, size_t len)
+  {
+    size_t n = 0;
+    while (len--) {
+      if (!write(*buf++)) {
+        break;
+      }
+      n++;
+    }
+    return n;
+  }
+  size_t write(const char *s) { return s ? write(reinterpret_cast<const uint8_t *>(s), strlen(s)) : 0; }
+  size_t write(const char *buf, size_t len) { return write(reinterpret_cast<const uint8_t *>(buf), len); }
+  virtual int availableForWrite() { return 0; }
+  virtual void flush() {}
+
+  size_t print(const __FlashStringHelper *s) { return write(reinterpret_cast<const char *>(s)); }
+  size_t print(const String &s) { return write(s.c_str()); }
+  size_t print(const char *s) { return write(s); }
+  size_t print(char c) { return write(static_cast<uint8_t>(c)); }
+  size_t print(unsigned char v, int base = DEC) { return print(static_cast<unsigned long>(v), base); }
+  size_t print(int v, int base = DEC) { return print(static_cast<long>(v), base); }
+  size_t print(unsigned int v, int base = DEC) { return print(static_cast<unsigned long>(v), base); }
+  size_t print(long v, int base = DEC)
+  {
+    if (base == DEC && v < 0) {
+      return write('-') + printNumber(0UL - static_cast<unsigned long>(v), DEC);
+    }
+    return printNumber(static_cast<unsigned long>(v), base);
+  }
+  size_t print(unsigned long v, int base = DEC) { return printNumber(v, base); }
+  size_t print(double v, int digits = 2)
+  {
+    char buf[64];
+    snprintf(buf, sizeof(buf), "%.*f", digits, v);
+    return write(buf);
+  }
+  size_t println() { return write("\r\n"); }
+  template <class T> size_t println(T v) { size_t n = print(v); return n + println(); }
+
+private:
+  size_t printNumber(unsigned long v, int base)
+  {
+    char buf[8 * sizeof(long) + 1];
+    char *p = buf + sizeof(buf);
+    *--p = '\0';
+    if (base < 2) {
+      base = 10;
+    }
+    do {
+      unsigned d = v % base;
+      v /= base;
+      *--p = d < 10 ? '0' + d : 'A' + d - 10;
+    } while (v);
+    return write(p);
+  }
+};
+
+/** Print sink collecting everything into a std::string */
+class StringPrint
+  : public Print
+{
+public:
+  size_t write(uint8_t c) override { str += static_cast<char>(c); writes++; return 1; }
+  size_t write(const uint8_t *buf, size_t len) override
+  {
+    str.append(reinterpret_cast<const char *>(buf), len);
+    writes++;
+    return len;
+  }
+  int availableForWrite() override { return room; }
+  using Print::write;
+  std::string str;
+  size_t writes = 0;
+  int room = 64;
+};
@@ -0,0 +1,73 @@
+/* Minimal self-registering test cases for the host build
+ *
+ * Check.h
+ *
+ *  Created on: Oct 14, 2026
+ */
+
+#pragma once
+
+#include <Arduino.h>
+
+namespace check {
+
+struct Case
+{
+  Case(const char *name, void (*fn)())
+    : name(name)
+    , fn(fn)
+    , next(head())
+  {
+    head() = this;
+  }
+  static Case *&head()
+  {
+    static Case *s_head = nullptr;
+    return s_head;
+  }
+  const char *name;
+  void (*fn)();
+  Case *next;
+};
+
+/** Number of failed checks */
+inline unsigned &failures()
+{
+  static unsigned s_failures = 0;
+  return s_failures;
+}
+
+inline void
+fail(const char *file, int line, const char *what)
+{
+  printf("%s:%d: check failed: %s\n", file, line, what);
+  failures()++;
+}
+
+/** 32-bit millisecond clock to exercise rollover on 64-bit hosts */
+struct Millis32Clock
+{
+  typedef uint32_t Ticks;
+  static Ticks now()                   { return static_cast<uint32_t>(millis()); }
+  static Ticks fromMs(unsigned long ms) { return ms; }
+  static unsigned long toMs(Ticks t)    { return t; }
+  static unsigned long toUs(Ticks t)    { return t * 1000UL; }
+};
+
+} // namespace check
+
+#define TEST_CASE(name) \
+  static void name(); \
+  static check::Case name##Case(#name, &name); \
+  static void name()
+
+#define CHECK(cond) \
+  do { if (not (cond)) { check::fail(__FILE__, __LINE__, #cond); } } while (0)
+
+#define CHECK_STR(str, expected) \
+  do { \
+    if (std::string(str) != (expected)) { \
+      check::fail(__FILE__, __LINE__, #str " == " #expected); \
+      printf("    got \"%s\"\n", std::string(str).c_str()); \
+    } \
+  } while (0)
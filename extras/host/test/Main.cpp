@@ -0,0 +1,24 @@
+/* Runs all host test cases, or the ones whose name contains argv[1]
+ *
+ * Main.cpp
+ *
+ *  Created on: Oct 14, 2026
+ */
+
+#include "Check.h"
+
+int
+main(int argc, char **argv)
+{
+  const char *filter = argc > 1 ? argv[1] : "";
+  unsigned n = 0;
+  for (auto c = check::Case::head(); c; c = c->next) {
+    if (strstr(c->name, filter)) {
+      mock::set(0);
+      c->fn();
+      n++;
+    }
+  }
+  printf("%u test cases, %u failed checks\n", n, check::failures());
+  return check::failures() ? 1 : 0;
+}
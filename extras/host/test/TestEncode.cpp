@@ -0,0 +1,74 @@
+/* Host tests of the binary encoders
+ *
+ * TestEncode.cpp
+ *
+ *  Created on: Oct 14, 2026
+ */
+
+#include "Check.h"
+
+#include <EwEncode.h>
+
+#include <math.h>
+
+using namespace ew;
+
+namespace {
+
+std::string
+hex(const BytePrint &buf)
+{
+  std::string s;
+  char h[4];
+  for (size_t i = 0; i < buf.length(); i++) {
+    snprintf(h, sizeof(h), "%02x", buf.data()[i]);
+    s += h;
+  }
+  return s;
+}
+
+} // namespace
+
+TEST_CASE(encoder)
+{
+  ByteBuffer<32> b;
+  Encoder e(b);
+  e.varint(0u).varint(127u).varint(300u).varint(4294967295UL);
+  CHECK(hex(b) == "007fac02ffffffff0f");
+  b.clear();
+  e.zigzag(0).zigzag(-1).zigzag(1).zigzag(-64).zigzag(int8_t(-128)).zigzag(-2147483647LL - 1);
+  CHECK(hex(b) == "000102" "7f" "ff01" "ffffffff0f");
+  b.clear();
+  e.fixed(21.37f, 2).fixed(-0.5f, 0).le16(0x1234).le32(0xdeadbeef).string("ab");
+  CHECK(hex(b) == "b221" "01" "3412" "efbeadde" "026162");
+
+  ByteBuffer<4> small;
+  Encoder f(small);
+  f.le32(1).u8(2);
+  CHECK(f.failed() and f.length() == 4 and small.overflowed());
+}
+
+TEST_CASE(cborWriter)
+{
+  ByteBuffer<64> b;
+  CborWriter w(b);
+  w.map(2).field(1, 500).field(2, "ab");
+  CHECK(hex(b) == "a2" "011901f4" "02626162");
+  b.clear();
+  w.array(6).integer(-500).integer(23u).integer(24).integer(4294967296ULL).integer(-1L).boolean(true);
+  CHECK(hex(b) == "86" "3901f3" "17" "1818" "1b0000000100000000" "20" "f5");
+  b.clear();
+  w.decimal(2137, -2).fixed(21.37f, 2).float32(1.5f).null();
+  CHECK(hex(b) == "c48221190859" "c48221190859" "fa3fc00000" "f6");
+  CHECK(w.length() == 9 + 18 + 18 and not w.failed());
+
+  /* more than nine decimals keep mantissa and exponent consistent */
+  b.clear();
+  w.fixed(1.5f, 12);
+  ByteBuffer<64> ref;
+  CborWriter(ref).decimal(1500000000L, -9);
+  CHECK(hex(b) == hex(ref));
+  CHECK(ew::detail::scaleDecimal(1e30f, 9) == LONG_MAX);
+  CHECK(ew::detail::scaleDecimal(-1e30f, 9) == LONG_MIN);
+  CHECK(ew::detail::scaleDecimal(NAN, 2) == 0);
+}
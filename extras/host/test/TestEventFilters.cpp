@@ -0,0 +1,91 @@
+/* Host tests of the debouncer, rate limiter and coalescer
+ *
+ * TestEventFilters.cpp
+ *
+ *  Created on: Oct 14, 2026
+ */
+
+#include "Check.h"
+
+#include <EwEventFilters.h>
+
+#include <vector>
+
+using namespace ew;
+
+TEST_CASE(debouncer)
+{
+  Debouncer<20> d(10);
+  CHECK(not d.update(17, true));
+  for (int i = 0; i < 9; i++) {
+    mock::advanceMs(1);
+    CHECK(not d.update(17, true));
+  }
+  mock::advanceMs(1);
+  CHECK(d.update(17, true) and d.state(17) and not d.state(16));
+  CHECK(not d.update(17, true));
+  /* bounces restart the window */
+  d.update(17, false);
+  mock::advanceMs(8);
+  d.update(17, true);
+  mock::advanceMs(20);
+  CHECK(not d.update(17, true) and d.state(17));
+  CHECK(sizeof(Debouncer<1000>) <= 2 * 1000 + 2 * 125 + 2);
+}
+
+TEST_CASE(rateLimiter)
+{
+  RateLimiter<4> r(3, 100);
+  int passed = 0;
+  for (int i = 0; i < 10; i++) {
+    passed += r.allow(2);
+  }
+  CHECK(passed == 3 and r.tokens(2) == 0 and r.tokens(1) == 3);
+  mock::advanceMs(99);
+  CHECK(not r.allow(2));
+  mock::advanceMs(1);
+  CHECK(r.allow(2) and not r.allow(2));
+  mock::advanceMs(250);
+  CHECK(r.tokens(2) == 2);
+  mock::advanceMs(40000);
+  CHECK(r.tokens(2) == 3);
+
+  /* a pause beyond 32767 ticks refills only what it earned */
+  RateLimiter<1> slow(5, 10000);
+  for (int i = 0; i < 5; i++) {
+    CHECK(slow.allow(0, 0));
+  }
+  CHECK(not slow.allow(0, 0) and slow.tokens(0, 32768) == 3);
+  CHECK(slow.tokens(0, 50000) == 5);
+}
+
+TEST_CASE(coalescer)
+{
+  Coalescer<> publish(200);
+  int publishes = 0;
+  for (int i = 0; i < 500; i++) {
+    publish.post();
+    mock::advanceUs(300);
+    publishes += publish.fire();
+  }
+  mock::advanceMs(50);
+  publishes += publish.fire();
+  CHECK(publishes == 1 and not publish.pending());
+
+  Coalescer<100> topics(10);
+  auto now = millis();
+  topics.post(3, now);
+  topics.post(77, now);
+  topics.post(77, now + 5);
+  std::vector<size_t> fired;
+  CHECK(topics.fireAll(now + 9, [&](size_t i) { fired.push_back(i); }) == 0);
+  CHECK(topics.fireAll(now + 10, [&](size_t i) { fired.push_back(i); }) == 2);
+  CHECK((fired == std::vector<size_t>{3, 77}));
+
+  /* a wrapped stamp delays by at most one window, polling in time doesn't */
+  topics.post(5, now);
+  CHECK(not topics.fire(5, now + 65536 + 5) and topics.fire(5, now + 65536 + 10));
+  topics.post(5, now);
+  CHECK(not topics.fire(5, now + 5) and topics.fire(5, now + 30000));
+  CHECK(not topics.fire(5, now + 65536 + 20));
+}
@@ -0,0 +1,267 @@
+/* Host tests of the print and format helpers
+ *
+ * TestPrint.cpp
+ *
+ *  Created on: Oct 14, 2026
+ */
+
+#include "Check.h"
+
+#include <EwBufferedPrint.h>
+#include <EwFmt.h>
+#include <EwLogQueue.h>
+#include <EwStreamFmt.h>
+#include <EwTaskStats.h>
+
+using namespace ew;
+
+TEST_CASE(fixedString)
+{
+  FixedString<16> a;
+  prtFmt(a, "x=%d", 42);
+  CHECK_STR(a.c_str(), "x=42");
+  a.print(" hello world!!");
+  CHECK_STR(a.c_str(), "x=42 hello worl");
+  CHECK(a.truncated() and a.length() == 15);
+  a = "abc";
+  a.appendFmt("%05d", 7);
+  a += 'z';
+  CHECK_STR(a.c_str(), "abc00007z");
+  CHECK(not a.truncated());
+  StringPrint out;
+  out << a << " " << 5;
+  CHECK_STR(out.str, "abc00007z 5");
+}
+
+TEST_CASE(integerPrinting)
+{
+  StringPrint o;
+  o << 0 << ' ' << -1 << ' ' << 4294967295UL << ' ' << (unsigned char)7 << ' '
+    << (short)-32768 << ' ' << -9223372036854775807LL - 1 << ' ' << 18446744073709551615ULL;
+  CHECK_STR(o.str, "0 -1 4294967295 7 -32768 -9223372036854775808 18446744073709551615");
+  for (uint64_t v : {0ULL, 9ULL, 10ULL, 99ULL, 100ULL, 43698ULL, 43699ULL, 99999999ULL,
+                     100000000ULL, 4294967295ULL, 4294967296ULL, 10000000000000000000ULL}) {
+    StringPrint p;
+    p << (unsigned long long)v;
+    CHECK_STR(p.str, std::to_string(v));
+  }
+}
+
+TEST_CASE(elapsed)
+{
+  for (unsigned long sec : {0UL, 1UL, 59UL, 60UL, 61UL, 3599UL, 3600UL, 3661UL, 86399UL,
+                            86400UL, 93784UL, 4294967295UL}) {
+    for (int all = 0; all < 2; all++) {
+      unsigned long d = numberOfDays(sec), h = numberOfHours(sec);
+      unsigned long m = numberOfMinutes(sec), s = numberOfSeconds(sec);
+      char ref[64];
+      if (d or all) {
+        snprintf(ref, sizeof(ref), "%lud %02luh %02lum %02lus", d, h, m, s);
+      } else if (h) {
+        snprintf(ref, sizeof(ref), "%luh %02lum %02lus", h, m, s);
+      } else if (m) {
+        snprintf(ref, sizeof(ref), "%lum %02lus", m, s);
+      } else {
+        snprintf(ref, sizeof(ref), "%lus", s);
+      }
+      String a;
+      fmtElapsed(a, sec, all);
+      CHECK_STR(a.c_str(), ref);
+      String b;
+      fmtElapsed(b, sec, all, "%lus", "%lum %02lus", "%luh %02lum %02lus", "%lud %02luh %02lum %02lus");
+      CHECK_STR(b.c_str(), ref);
+      StringPrint o;
+      prtElapsed(o, sec, all);
+      CHECK_STR(o.str, ref);
+    }
+  }
+}
+
+#define CHECK_STREAM_FMT(...) \
+  do { \
+    StringPrint o; \
+    streamFmt(o, __VA_ARGS__); \
+    char ref[256]; \
+    snprintf(ref, sizeof(ref), __VA_ARGS__); \
+    CHECK_STR(o.str, ref); \
+  } while (0)
+
+TEST_CASE(streamFmtMatchesPrintf)
+{
+  CHECK_STREAM_FMT("%d|%5d|%-5d|%05d|%+d|% d", 42, -42, 42, -42, 7, 7);
+  CHECK_STREAM_FMT("%x %X %#x %#08x %o %#o", 255u, 255u, 255u, 255u, 8u, 8u);
+  CHECK_STREAM_FMT("%ld %lu %lld %llu %zu", -1L, 4000000000UL, -5LL, 18446744073709551615ULL, (size_t)12);
+  CHECK_STREAM_FMT("%s|%10s|%-10s|%.3s|%*s|%-*.*s|", "abc", "abc", "abc", "abcdef", 6, "ab", 6, 2, "abcd");
+  CHECK_STREAM_FMT("%f %.2f %10.3f %-10.1f| %08.2f %e %g", 3.14159, 2.5, -1.5, 1.25, -3.5, 12345.678, 0.0001);
+  CHECK_STREAM_FMT("%100d|%-40s|%040d", 5, "x", -12);
+  CHECK_STREAM_FMT("%.30d|%-34.28x|%#.26o|%#32.24X|%.0d|", -7, 255u, 8u, 255u, 0);
+  CHECK_STREAM_FMT("%08f|%-8f|%08.2f|%08f|", INFINITY, -INFINITY, 1.5, NAN);
+  CHECK_STREAM_FMT("%.30f", 1.0 / 3);
+  CHECK_STREAM_FMT("%Lf|%10.3Le|%Lg", 3.25L, -1.5L, 0.125L);
+}
+
+TEST_CASE(streamFmtLimits)
+{
+  StringPrint o;
+  volatile int minWidth = INT_MIN;
+  streamFmt(o, "%123456789d|%*d|%.*d", 1, int(minWidth), 2, 99999, 3);
+  CHECK(o.str.size() == 3 * 9999 + 2);
+  CHECK(o.str.compare(9998, 2, "1|") == 0);
+  CHECK(o.str.compare(10000, 2, "2 ") == 0);
+  CHECK(o.str.compare(o.str.size() - 2, 2, "03") == 0);
+
+  /* wide characters are skipped without losing track of the arguments */
+  o.str.clear();
+  streamFmt(o, "%ls|%lc|%d", L"wide", L'w', 42);
+  CHECK_STR(o.str, "%ls|%lc|42");
+}
+
+#define CHECK_EW_PRT_FMT(format, ...) \
+  do { \
+    StringPrint o; \
+    EW_PRT_FMT(o, format, ##__VA_ARGS__); \
+    char ref[512]; \
+    snprintf(ref, sizeof(ref), format, ##__VA_ARGS__); \
+    CHECK_STR(o.str, ref); \
+  } while (0)
+
+TEST_CASE(typedFmtMatchesPrintf)
+{
+  CHECK_EW_PRT_FMT("hello %% world");
+  CHECK_EW_PRT_FMT("%d|%5d|%-5d|%05d|%+d|% d|%.3d|%.0d", 42, -42, 42, -42, 7, 7, 5, 0);
+  CHECK_EW_PRT_FMT("%x %X %#x %#08x %o %#o %u", 255u, 255u, 255u, 255u, 8u, 8u, 4000000000u);
+  CHECK_EW_PRT_FMT("%ld %lu %lld %llu %lx", -1L, 4000000000UL, -5LL, 18446744073709551615ULL, 0xdeadbeefUL);
+  CHECK_EW_PRT_FMT("%s|%10s|%-10s|%.3s|", "abc", "abc", "abc", "abcdef");
+  CHECK_EW_PRT_FMT("%c%c %5c|%-3c|", 'a', 'b', 'c', 'd');
+  CHECK_EW_PRT_FMT("%f %.2f %10.3f %-10.1f| %08.2f %+.1f", 3.14159, 2.5, -1.5, 1.25, -3.5, 2.0);
+  CHECK_EW_PRT_FMT("%.0f %.0f %.1f %.2f %#.0f %f", 2.5, 3.5, 0.25, 0.125, 7.0, -0.0);
+  CHECK_EW_PRT_FMT("%f %.3f %f %.1f", 5e9, -1234567890123.4567, 1e20, 0.96);
+  CHECK_EW_PRT_FMT("%08f|%-6f|%5F|% f|%.12f", INFINITY, -INFINITY, NAN, 1.0f, 1.0 / 3);
+  CHECK_EW_PRT_FMT("%.40d|%-45.41x|%#.30o|%255d|", -7, 255u, 8u, 1);
+  static_assert(ew::detail::fmtWidthsOk("%255d %.255f %%999"), "widths up to 255");
+  static_assert(not ew::detail::fmtWidthsOk("%256d"), "width above 255");
+  static_assert(not ew::detail::fmtWidthsOk("%-1.300s"), "precision above 255");
+  String st("str");
+  FixedString<8> fs("fix");
+  StringPrint o;
+  EW_PRT_FMT(o, "%s %s %d", st, fs, 'A');
+  CHECK_STR(o.str, "str fix 65");
+
+  /* the conversions are parsed at compile time */
+  constexpr ew::detail::FmtSpecs<2> specs = ew::detail::fmtSpecs<2>("a%%b%-08.3lxc%5s");
+  static_assert(specs.spec[0].left and specs.spec[0].zero and specs.spec[0].width == 8
+                and specs.spec[0].prec == 3 and specs.spec[0].conv == 'x' and specs.spec[0].end == 12,
+                "first conversion");
+  static_assert(specs.spec[1].width == 5 and specs.spec[1].prec == -1 and specs.spec[1].conv == 's',
+                "second conversion");
+  /* formats not known at compile time get their table at runtime */
+  const char *runtime = "%d|%999d|%";
+  o.str.clear();
+  ew::fmt(o, runtime, 1, 2);
+  CHECK(o.str.size() == 2 + 255 + 2 and o.str.compare(o.str.size() - 4, 4, " 2|%") == 0);
+}
+
+TEST_CASE(bufferedPrint)
+{
+  StringPrint s;
+  {
+    BufferedPrint<16> out(s);
+    out << "a=" << 12 << " b=" << -3 << "\r\n";
+    CHECK(s.writes == 1);
+    CHECK_STR(s.str, "a=12 b=-3\r\n");
+    out << "xyz";
+    CHECK(s.writes == 1);
+  }
+  CHECK_STR(s.str, "a=12 b=-3\r\nxyz");
+  s.str.clear();
+  s.writes = 0;
+  BufferedPrint<8> out(s, false);
+  out << "0123456789abcdefghij";
+  CHECK(s.writes == 1);
+  out << "01234" << "5678";
+  out.flush();
+  CHECK_STR(s.str, "0123456789abcdefghij012345678");
+}
+
+TEST_CASE(logQueue)
+{
+  LogQueue<16> q;
+  StringPrint s;
+  s.room = 5;
+  prtFmt(q, "hello %d\n", 42);
+  q << "abcdef";
+  CHECK(q.available() == 15);
+  q << "x";
+  CHECK(q.dropped() == 1);
+  CHECK(q.drain(s) == 5);
+  q << "1234";
+  LogDrain<16> drain(q, s);
+  mock::advanceMs(2);
+  drain.run();
+  CHECK_STR(s.str, "hello 42\na");
+  s.room = 100;
+  mock::advanceMs(2);
+  drain.run();
+  CHECK_STR(s.str, "hello 42\nabcdef1234");
+  CHECK(q.empty());
+}
+
+TEST_CASE(logQueueLarge)
+{
+  static_assert(sizeof(detail::IndexType<254>::type) == 1, "byte index");
+  static_assert(sizeof(detail::IndexType<65534>::type) == 2, "16-bit index");
+  static_assert(sizeof(detail::IndexType<65536>::type) == 4, "32-bit index");
+  static LogQueue<1UL << 17> q;
+  static uint8_t chunk[40000];
+  memset(chunk, 'a', sizeof(chunk));
+  for (int i = 0; i < 3; i++) {
+    CHECK(q.write(chunk, sizeof(chunk)) == sizeof(chunk));
+  }
+  CHECK(q.available() == 120000);
+  StringPrint s;
+  CHECK(q.drain(s, 100000) == 100000);
+  CHECK(q.write(chunk, sizeof(chunk)) == sizeof(chunk));
+  CHECK(q.available() == 60000 and q.dropped() == 0);
+}
+
+TEST_CASE(taskStats)
+{
+  struct S : PeriodicalBase<S, MillisClock, TaskStats>
+  {
+    S() : PeriodicalBase<S, MillisClock, ew::TaskStats>(10) { stats().setName("sampler"); }
+    void task() { mock::advanceUs(150); }
+  };
+  S s;
+  for (int i = 0; i < 1000; i++) {
+    s.run();
+    mock::advanceMs(1);
+  }
+  CHECK(s.stats().count() == 92);
+  CHECK(s.stats().minExecUs() == 150 and s.stats().maxExecUs() == 150);
+  CHECK(s.stats().bucket(4) == 92);
+  StringPrint out;
+  out << TaskStats::All();
+  CHECK(out.str.find("sampler: n 92") == 0);
+}
+
+TEST_CASE(flashFormats)
+{
+  char buf[16];
+  CHECK_STR(prtFmt(buf, sizeof(buf), F("x=%d"), 42), "x=42");
+  StringPrint o;
+  prtFmt(o, F("%s=%u"), "n", 7u);
+  prtFmt<4>(o, F("%d"), 12345);
+  CHECK_STR(o.str, "n=7123");
+  String s;
+  prtFmt(s, F("%03d"), 5);
+  CHECK_STR(s.c_str(), "005");
+  FixedString<8> f;
+  prtFmt(f, F("%d"), 1);
+  f.appendFmt(F("-%s"), "abcdefgh");
+  CHECK_STR(f.c_str(), "1-abcde");
+  CHECK(f.truncated());
+  fmtElapsed(f, 3661, false, F("%lus"), F("%lum"), F("%luh%02lum"));
+  CHECK_STR(f.c_str(), "1h01m");
+  fmtElapsed(s, 90000, false, F("%lus"));
+  CHECK_STR(s.c_str(), "1d 01h 00m 00s");
+}
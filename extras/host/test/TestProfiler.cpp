@@ -0,0 +1,83 @@
+/* Host tests of the loop profiler
+ *
+ * TestProfiler.cpp
+ *
+ *  Created on: Oct 14, 2026
+ */
+
+#include "Check.h"
+
+#include <EwLoopProfiler.h>
+
+using namespace ew;
+
+TEST_CASE(quantileSketch)
+{
+  typedef QuantileSketch<16, 2> Sketch;
+  CHECK(Sketch::NumBuckets == 60);
+  for (uint32_t v = 0; v <= Sketch::MaxValue; v++) {
+    uint16_t b = Sketch::bucket(v);
+    CHECK(v <= Sketch::upper(b) and (b == 0 or v > Sketch::upper(b - 1)));
+  }
+  CHECK(Sketch::bucket(0xFFFFFFFF) == Sketch::NumBuckets - 1);
+  Sketch s;
+  CHECK(s.quantile(500) == 0);
+  for (uint32_t v = 1; v <= 1000; v++) {
+    s.add(v);
+  }
+  CHECK(s.count() == 1000);
+  CHECK(s.quantile(500) >= 500 and s.quantile(500) < 500 * 5 / 4);
+  CHECK(s.quantile(990) >= 990 and s.quantile(990) < 990 * 5 / 4);
+  for (long i = 0; i < 200000; i++) {
+    s.add(3);
+  }
+  CHECK(s.count() < 65536 and s.quantile(990) == 3);
+}
+
+TEST_CASE(loopProfiler)
+{
+  struct Sampler : PeriodicalBase<Sampler, MillisClock, ProfileSlot>
+  {
+    Sampler() : PeriodicalBase<Sampler, MillisClock, ew::ProfileSlot>(10) { stats().setName("sampler"); }
+    void task() { mock::advanceUs(2000); }
+  };
+  LoopProfiler profiler;
+  Sampler sampler;
+  ProfileSlot other("other");
+  for (int i = 0; i < 100; i++) {
+    profiler.beginLoop();
+    sampler.run();
+    {
+      ProfileSlot::Scope scope(other);
+      mock::advanceUs(100);
+    }
+    {
+      ProfileSlot::Scope idle(profiler.idle());
+      mock::advanceUs(900);
+    }
+    profiler.endLoop();
+  }
+  CHECK(profiler.loops() == 100);
+  CHECK(profiler.permille(sampler.stats()) == 166);
+  CHECK(profiler.permille(profiler.idle()) == 750);
+  CHECK(profiler.p50() == 1023 and profiler.p99() == 3071);
+
+  StringPrint bin;
+  profiler.writeFrame(bin);
+  CHECK(bin.str.compare(0, 4, "EWP\x01") == 0);
+  CHECK(uint8_t(bin.str[8]) == 100 and uint8_t(bin.str[24]) == 3);
+  CHECK(bin.str.compare(29, 5, "\x04idle") == 0);
+  CHECK(bin.str.size() == 25 + 3 * 5 + 4 + 5 + 7);
+  CHECK(profiler.loops() == 0 and other.busyUs() == 0);
+
+  StringPrint txt;
+  profiler.setReport(txt, 50);
+  for (int i = 0; i < 60; i++) {
+    profiler.beginLoop();
+    sampler.run();
+    mock::advanceMs(1);
+    profiler.endLoop();
+  }
+  CHECK(txt.str.find("loop n 40, us p50 1023 p95 3071 p99 3071, idle 0.0%") == 0);
+  CHECK(txt.str.find(", other 0.0%, sampler 20.0%") != std::string::npos);
+}
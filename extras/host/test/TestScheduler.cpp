@@ -0,0 +1,335 @@
+/* Host tests of the scheduling infrastructure
+ *
+ * TestScheduler.cpp
+ *
+ *  Created on: Oct 14, 2026
+ */
+
+#include "Check.h"
+
+#include <EwLoadGovernor.h>
+#include <EwScheduler.h>
+#include <EwSliced.h>
+#include <EwTaskList.h>
+#include <EwTaskSet.h>
+
+TEST_CASE(schedulerRunsDueTasks)
+{
+  static unsigned fired, timeouts;
+  struct P : PeriodicalBase<P>
+  {
+    P() : PeriodicalBase<P>(10) {}
+    void task() { fired++; }
+  };
+  fired = timeouts = 0;
+  P p;
+  Timer t(25);
+  ew::Scheduler<4> s;
+  s.add(p);
+  s.add(t, [](void *) { timeouts++; });
+  t.start();
+  for (int i = 0; i < 100; i++) {
+    CHECK(s.run() != ew::TickTraits<unsigned long>::Never);
+    mock::advanceMs(1);
+  }
+  CHECK(fired == 9);
+  CHECK(timeouts == 1);
+  s.remove(&t);
+  CHECK(s.size() == 1);
+}
+
+TEST_CASE(schedulerOneNowPerPass)
+{
+  static unsigned slow, fast;
+  struct Slow : PeriodicalBase<Slow>
+  {
+    Slow() : PeriodicalBase<Slow>(10) {}
+    void task() { mock::advanceMs(++slow == 1 ? 5 : 0); }
+  };
+  struct Fast : PeriodicalBase<Fast>
+  {
+    Fast() : PeriodicalBase<Fast>(10) {}
+    void task() { fast++; }
+  };
+  slow = fast = 0;
+  Slow a;
+  Fast b;
+  ew::Scheduler<2> s;
+  s.add(a);
+  s.add(b);
+  mock::advanceMs(11);
+  /* both ran at the same now, the sleep is what is left after them */
+  CHECK(s.poll() == 6 and slow == 1 and fast == 1);
+  mock::advanceMs(6);
+  s.poll();
+  CHECK(slow == 2 and fast == 2);
+}
+
+TEST_CASE(schedulerMicros)
+{
+  static unsigned n;
+  struct P : PeriodicalBase<P, ew::MicrosClock>
+  {
+    P() : PeriodicalBase<P, ew::MicrosClock>(200) {}
+    void task() { n++; }
+  };
+  n = 0;
+  P p;
+  MicroTimer t(500, Timer::Periodic);
+  t.start();
+  ew::Scheduler<4, ew::MicrosClock> s;
+  s.add(p);
+  s.add(t, [](void *) { n += 1000; });
+  for (int i = 0; i < 10000; i++) {
+    s.run();
+    mock::advanceUs(1);
+  }
+  CHECK(n == 19049);
+}
+
+namespace {
+
+struct Compactor : ew::SlicedPeriodicalBase<Compactor>
+{
+  Compactor() : ew::SlicedPeriodicalBase<Compactor>(100, 2000), pages(0) {}
+  Result task()
+  {
+    EW_SLICE_BEGIN();
+    for (m_page = 0; m_page < 40; m_page++) {
+      mock::advanceUs(500);
+      pages++;
+      EW_SLICE_CHECK();
+    }
+    EW_SLICE_YIELD();
+    pages += 1000;
+    EW_SLICE_END();
+  }
+  uint16_t m_page;
+  unsigned pages;
+};
+
+} // namespace
+
+TEST_CASE(slicedTask)
+{
+  Compactor c;
+  c.run();
+  CHECK(not c.pending());
+  mock::advanceMs(101);
+  c.run();
+  CHECK(c.pending() and c.pages == 4);
+  while (c.pending()) {
+    c.run();
+  }
+  CHECK(c.pages == 1040);
+}
+
+TEST_CASE(slicedTaskInSchedulerGaps)
+{
+  static unsigned fast;
+  struct Fast : PeriodicalBase<Fast>
+  {
+    Fast() : PeriodicalBase<Fast>(5) {}
+    void task() { fast++; }
+  };
+  fast = 0;
+  Fast f;
+  Compactor c;
+  ew::Scheduler<4> s;
+  s.add(f);
+  s.add(c);
+  for (int i = 0; i < 3000; i++) {
+    mock::advanceUs(100);
+    s.run();
+  }
+  CHECK(c.pages >= 2040);
+  CHECK(fast >= 40);
+}
+
+TEST_CASE(loadGovernor)
+{
+  static ew::LoadGovernor governor(1000);
+  /* constant initialisation, registering tasks can't precede it */
+  constexpr ew::LoadGovernor constant(1000);
+  static_cast<void>(constant);
+  struct Housekeeping : ew::AdaptivePeriodicalBase<Housekeeping>
+  {
+    Housekeeping() : ew::AdaptivePeriodicalBase<Housekeeping>(governor, 10, Low, 3) {}
+    void task() {}
+  };
+  struct Display : ew::AdaptivePeriodicalBase<Display>
+  {
+    Display() : ew::AdaptivePeriodicalBase<Display>(governor, 10, Normal, 4) {}
+    void task() {}
+  };
+  struct Motor : ew::AdaptivePeriodicalBase<Motor>
+  {
+    Motor() : ew::AdaptivePeriodicalBase<Motor>(governor, 10, Critical) {}
+    void task() {}
+  };
+  Housekeeping h;
+  Display d;
+  Motor m;
+  /* eight adjustments: two for Low to reach its maximum, Normal follows */
+  for (int i = 0; i < 400; i++) {
+    governor.begin();
+    mock::advanceUs(2000);
+    h.run();
+    d.run();
+    m.run();
+    governor.end();
+  }
+  CHECK(governor.overloaded());
+  CHECK(h.factor() == 3 and h.getPeriodMs() == 30);
+  CHECK(d.factor() == 4 and d.getPeriodMs() == 40);
+  CHECK(m.factor() == 1 and m.getPeriodMs() == 10);
+  CHECK(governor.stretch(ew::LoadGovernor::Normal) == 4);
+  /* recovery relieves Normal first and Low right after it */
+  for (int i = 0; i < 9000; i++) {
+    governor.begin();
+    mock::advanceUs(100);
+    h.run();
+    d.run();
+    governor.end();
+  }
+  CHECK(h.factor() == 1 and h.getPeriodMs() == 10);
+  CHECK(d.factor() == 1 and d.getPeriodMs() == 10);
+}
+
+namespace {
+
+std::string order;
+
+struct Slow : PeriodicalBase<Slow>
+{
+  static const unsigned long PeriodMs = 100;
+  Slow() : PeriodicalBase<Slow>(PeriodMs) {}
+  void task() { order += 's'; }
+};
+struct Fast : PeriodicalBase<Fast>
+{
+  static const unsigned long PeriodMs = 10;
+  Fast() : PeriodicalBase<Fast>(PeriodMs) {}
+  void task() { order += 'f'; }
+};
+struct Plain : PeriodicalBase<Plain>
+{
+  Plain() : PeriodicalBase<Plain>(50) {}
+  void task() { order += 'p'; }
+};
+/* a member PeriodMs as in the PeriodicalBase example and an own run() */
+struct Member : PeriodicalBase<Member>
+{
+  const unsigned long PeriodMs = 20;
+  Member() : PeriodicalBase<Member>(20) {}
+  void run() { PeriodicalBase<Member>::run(); }
+  void task() { order += 'm'; }
+};
+
+} // namespace
+
+TEST_CASE(taskSet)
+{
+  typedef ew::TaskSet<Plain, Slow, Fast> Set;
+  static_assert(ew::detail::IsSame<Set::Order, ew::detail::TypeList<Fast, Slow, Plain> >::value,
+                "sorted by PeriodMs");
+  static_assert(Set::MinPeriodMs == 10 and Set::size() == 3, "");
+  Set tasks;
+  order.clear();
+  mock::advanceMs(101);
+  tasks.run();
+  CHECK(order == "fsp");
+  CHECK(tasks.remaining() == 11 and tasks.get<Plain>().getPeriod() == 50);
+  tasks.get<Fast>().setPeriod(5);
+  CHECK(tasks.remaining() == 6);
+
+  ew::Scheduler<2> scheduler([](unsigned long ms) { delay(ms); });
+  CHECK(scheduler.add(tasks));
+  order.clear();
+  for (int i = 0; i < 60; i++) {
+    scheduler.run();
+  }
+  CHECK(order.find('p') != std::string::npos and order.find('s') != std::string::npos);
+  CHECK(millis() > 101 + 100);
+
+  typedef ew::TaskSet<Member, Fast> Mixed;
+  static_assert(ew::detail::IsSame<Mixed::Order, ew::detail::TypeList<Fast, Member> >::value,
+                "member PeriodMs goes last");
+  Mixed mixed;
+  order.clear();
+  mock::advanceMs(21);
+  mixed.run();
+  CHECK(order == "fm" and mixed.remaining() == 11);
+}
+
+namespace {
+
+struct Session : TimerBase<Session>
+{
+  Session(int id, ew::ObjectPool<ew::Listed<Session>, 3> &pool)
+    : TimerBase<Session>(id * 10)
+    , id(id)
+    , pool(pool)
+  {}
+  void onExpired()
+  {
+    order += char('0' + id);
+    pool.destroy(static_cast<ew::Listed<Session> *>(this));
+  }
+  int id;
+  ew::ObjectPool<ew::Listed<Session>, 3> &pool;
+};
+
+} // namespace
+
+TEST_CASE(taskList)
+{
+  ew::IntrusiveList<ew::ListHook> list;
+  {
+    ew::ListHook a, b;
+    list.pushBack(a);
+    list.pushFront(b);
+    CHECK(list.size() == 2 and &list.front() == &b and a.linked());
+  }
+  CHECK(list.empty());
+
+  ew::ObjectPool<ew::Listed<Session>, 3> pool;
+  ew::TaskList<> tasks;
+  order.clear();
+  for (int id = 1; id <= 4; id++) {
+    if (auto s = pool.create(id, pool)) {
+      s->start();
+      tasks.add(*s);
+    }
+  }
+  CHECK(pool.available() == 0 and tasks.size() == 3);
+  CHECK(tasks.remaining() == 11);
+  ew::Scheduler<2> scheduler([](unsigned long ms) { delay(ms); });
+  scheduler.add(tasks);
+  for (int i = 0; i < 10 and not tasks.empty(); i++) {
+    scheduler.run();
+  }
+  CHECK(order == "123" and tasks.empty() and pool.used() == 0);
+  CHECK(tasks.remaining() == ew::TickTraits<unsigned long>::Never);
+  auto s = pool.create(9, pool);
+  CHECK(pool.owns(s) and not s->linked());
+  pool.destroy(s);
+
+  /* a virtual run() overridden below Listed is reached through the hook */
+  struct Task
+  {
+    typedef ew::MillisClock Clock;
+    virtual ~Task() {}
+    virtual void run() { order += 'b'; }
+    unsigned long remaining() const { return 7; }
+  };
+  struct Override : ew::Listed<Task>
+  {
+    void run() override { order += 'o'; }
+  };
+  Override o;
+  tasks.add(o);
+  order.clear();
+  tasks.run();
+  CHECK(order == "o" and tasks.remaining() == 7);
+}
@@ -0,0 +1,420 @@
+/* Host tests of the timers and periodicals
+ *
+ * TestTimer.cpp
+ *
+ *  Created on: Oct 14, 2026
+ */
+
+#include "Check.h"
+
+#include <EwAtomicTimer.h>
+#include <EwClock64.h>
+#include <EwHwTimer.h>
+#include <EwTimerArray.h>
+#include <EwTimerDispatcher.h>
+#include <EwTimerQueue.h>
+
+#include <stdlib.h>
+#include <vector>
+
+TEST_CASE(timerOneShot)
+{
+  Timer t(10);
+  CHECK(not t.running() and not t.expired());
+  t.start();
+  mock::advanceMs(10);
+  CHECK(not t.expired());
+  CHECK(t.remaining() == 1);
+  mock::advanceMs(1);
+  CHECK(t.expired());
+  CHECK(not t.expired() and not t.running());
+}
+
+TEST_CASE(timerPeriodicRollover)
+{
+  mock::set(0xFFFFFFF0UL);
+  BasicTimer<check::Millis32Clock> t(4, TimerModes::Periodic);
+  t.start();
+  unsigned n = 0;
+  for (int i = 0; i < 100; i++) {
+    mock::advanceMs(1);
+    n += t.expired();
+  }
+  CHECK(n == 20);
+}
+
+TEST_CASE(timerBase)
+{
+  static unsigned fired;
+  struct Blink : TimerBase<Blink, TimerModes::Periodic, 5>
+  {
+    void onExpired() { fired++; }
+  };
+  struct Once : TimerBase<Once>
+  {
+    Once() : TimerBase<Once>(3) {}
+    void onExpired() { fired += 100; }
+  };
+  static_assert(sizeof(Blink) == 2 * sizeof(unsigned long), "no storage for the timeout");
+  fired = 0;
+  Blink b;
+  Once o;
+  b.start();
+  o.start();
+  for (int i = 0; i < 30; i++) {
+    mock::advanceMs(1);
+    b.run();
+    o.run();
+  }
+  CHECK(fired == 105);
+  CHECK(b.running() and not o.running());
+}
+
+TEST_CASE(compactTimer)
+{
+  ShortTimer s(10);
+  CHECK(ShortTimer::MaxTimeout == 16383);
+  s.start();
+  mock::advanceMs(11);
+  CHECK(s.expired() and not s.running());
+  /* out of range timeouts clamp instead of wrapping to short ones */
+  s.setTimeout(16384);
+  CHECK(s.getTimeout() == 16383);
+  s.start(20000);
+  mock::advanceMs(5000);
+  CHECK(not s.expired() and s.getTimeout() == 16383);
+  CHECK(ShortTimer(65535).getTimeout() == 16383);
+  CompactTimer p(3, TimerModes::Periodic);
+  p.start();
+  unsigned n = 0;
+  for (int i = 0; i < 40; i++) {
+    mock::advanceMs(1);
+    n += p.expired();
+  }
+  CHECK(n == 10);
+}
+
+namespace {
+
+template <PeriodicalModes::Phase PhaseV>
+struct PhasedTask : PeriodicalBase<PhasedTask<PhaseV>, ew::MillisClock, ew::NoTaskStats, PhaseV>
+{
+  PhasedTask() : PeriodicalBase<PhasedTask<PhaseV>, ew::MillisClock, ew::NoTaskStats, PhaseV>(10), n(0) {}
+  void task() { n++; }
+  unsigned n;
+};
+
+template <PeriodicalModes::Phase PhaseV>
+void
+checkPhase(unsigned expected, unsigned stalled, unsigned long missed)
+{
+  mock::set(0);
+  PhasedTask<PhaseV> p;
+  for (int i = 0; i < 10000; i++) {
+    mock::advanceMs(1);
+    p.run();
+  }
+  CHECK(p.n == expected);
+  /* stall for nine periods */
+  mock::advanceMs(95);
+  p.n = 0;
+  for (int i = 0; i < 20; i++) {
+    p.run();
+  }
+  CHECK(p.n == stalled and p.missed() == missed);
+}
+
+} // namespace
+
+TEST_CASE(periodicalPhases)
+{
+  checkPhase<PeriodicalModes::Restart>(909, 1, 0);
+  checkPhase<PeriodicalModes::Skip>(1000, 1, 8);
+  checkPhase<PeriodicalModes::Burst>(1000, 9, 0);
+  /* the default mode keeps the layout of a plain period and schedule */
+  static_assert(sizeof(PeriodicalBase<PhasedTask<PeriodicalModes::Restart> >) == 2 * sizeof(unsigned long),
+                "Restart adds nothing");
+  static_assert(sizeof(InlinePeriodical<>) < sizeof(InlinePeriodical<2 * sizeof(void *), PeriodicalModes::Skip>),
+                "missed runs are counted for the locked modes only");
+}
+
+TEST_CASE(inlinePeriodical)
+{
+  static int n;
+  n = 0;
+  int *pn = &n;
+  InlinePeriodical<> p(5, [pn] { (*pn)++; });
+  Periodical q(5, [pn] { (*pn) += 10; });
+  for (int i = 0; i < 13; i++) {
+    mock::advanceMs(1);
+    p.run();
+    q.run();
+  }
+  CHECK(n == 22);
+}
+
+static int s_freeRuns;
+static void freeTask()
+{
+  s_freeRuns++;
+}
+
+TEST_CASE(inlinePeriodicalFreeFunction)
+{
+  s_freeRuns = 0;
+  InlinePeriodical<> p(5, freeTask);
+  InlinePeriodical<> q(5, &freeTask);
+  void (*none)() = nullptr;
+  InlinePeriodical<> empty(5, none);
+  CHECK(not ew::InlineFunction<>(none));
+  CHECK(empty.remaining() == ew::TickTraits<unsigned long>::Never);
+  for (int i = 0; i < 13; i++) {
+    mock::advanceMs(1);
+    p.run();
+    q.run();
+    empty.run();
+  }
+  CHECK(s_freeRuns == 4);
+}
+
+TEST_CASE(timerQueueMatchesTimer)
+{
+  const int N = 50;
+  ew::TimerQueue<N> q;
+  Timer ref[N];
+  srand(1);
+  for (int step = 0; step < 50000; step++) {
+    int id = rand() % N;
+    int op = rand() % 10;
+    if (op == 0) {
+      unsigned long timeout = rand() % 50;
+      auto mode = rand() % 2 ? Timer::OneShot : Timer::Periodic;
+      q.start(id, timeout, mode);
+      ref[id].setMode(mode);
+      ref[id].start(timeout);
+    } else if (op == 1) {
+      q.stop(id);
+      ref[id].stop();
+    }
+    std::vector<bool> got(N, false);
+    q.poll([&](uint8_t i) {
+      got[i] = true;
+    });
+    for (int i = 0; i < N; i++) {
+      CHECK(ref[i].expired() == got[i]);
+      CHECK(q.running(i) == (ref[i].running() and ref[i].getTimeout()));
+    }
+    if (rand() % 3 == 0) {
+      mock::advanceMs(rand() % 7);
+    }
+  }
+}
+
+TEST_CASE(timerArrayMatchesTimer)
+{
+  const size_t N = 77;
+  ew::TimerArray<N, ew::MillisClock, uint16_t> a;
+  Timer ref[N];
+  srand(2);
+  for (size_t i = 0; i < N; i++) {
+    if (rand() % 4) {
+      uint16_t timeout = rand() % 20;
+      auto mode = rand() % 2 ? Timer::Periodic : Timer::OneShot;
+      a.start(i, timeout, mode);
+      ref[i].setMode(mode);
+      ref[i].start(timeout);
+    }
+  }
+  for (int step = 0; step < 200; step++) {
+    mock::advanceMs(1);
+    std::vector<bool> got(N, false);
+    a.forEachExpired([&](size_t i) {
+      got[i] = true;
+      if (i % 7 == 0) {
+        a.start(i);
+      }
+    });
+    for (size_t i = 0; i < N; i++) {
+      bool e = ref[i].expired();
+      CHECK(e == got[i]);
+      if (e and i % 7 == 0) {
+        ref[i].start();
+      }
+      CHECK(a.running(i) == ref[i].running());
+    }
+  }
+
+  /* long timeouts are clamped, not truncated */
+  ew::TimerArray<2, ew::MillisClock, uint16_t> clamped;
+  clamped.start(0, 70000);
+  clamped.setTimeout(1, 100000);
+  CHECK(clamped.getTimeout(0) == 65535 and clamped.getTimeout(1) == 65535);
+  mock::advanceMs(4465);
+  CHECK(not clamped.expired(0));
+  mock::advanceMs(65535 - 4465 + 1);
+  CHECK(clamped.expired(0));
+}
+
+TEST_CASE(atomicTimer)
+{
+  ew::AtomicTimer t(10);
+  CHECK(not t.running() and not t.expired());
+  t.startFromIsr();
+  CHECK(t.running() and t.remaining() == 11);
+  mock::advanceMs(11);
+  CHECK(t.expired() and not t.expired() and not t.running());
+  t.startFromIsr();
+  mock::advanceMs(5);
+  t.startFromIsr();
+  mock::advanceMs(6);
+  CHECK(not t.expired());
+  mock::advanceMs(5);
+  CHECK(t.expired());
+  /* 256 restarts between two polls are not mistaken for none */
+  t.startFromIsr();
+  mock::advanceMs(11);
+  CHECK(t.expired());
+  for (int i = 0; i < 256; i++) {
+    t.startFromIsr();
+  }
+  CHECK(t.running() and not t.expired());
+  mock::advanceMs(11);
+  CHECK(t.expired());
+}
+
+namespace {
+
+struct FakeHwTimer
+{
+  typedef ew::MicrosClock Clock;
+  static void begin(void (*handler)(void *), void *ctx)
+  {
+    s_handler = handler;
+    s_ctx = ctx;
+  }
+  static void arm(unsigned long us)  { s_armed = true; s_at = mock::us + us; }
+  static void disarm()               { s_armed = false; }
+  static void tick()
+  {
+    if (s_armed and mock::us >= s_at) {
+      s_armed = false;
+      s_handler(s_ctx);
+    }
+  }
+  static void (*s_handler)(void *);
+  static void *s_ctx;
+  static bool s_armed;
+  static uint64_t s_at;
+};
+void (*FakeHwTimer::s_handler)(void *);
+void *FakeHwTimer::s_ctx;
+bool FakeHwTimer::s_armed;
+uint64_t FakeHwTimer::s_at;
+
+ew::HwTimerMux<FakeHwTimer, 4> hwTimers;
+unsigned hwCallbacks;
+
+void onHwTimer(void *)
+{
+  if (++hwCallbacks < 3) {
+    hwTimers.start(0, 100);
+  }
+}
+
+} // namespace
+
+TEST_CASE(hwTimerMux)
+{
+  hwTimers.begin();
+  hwTimers.attach(0, onHwTimer);
+  hwTimers.start(0, 100);
+  hwTimers.start(1, 250);
+  hwTimers.start(2, 50, TimerModes::Periodic);
+  unsigned periodic = 0;
+  for (int i = 0; i < 1000; i++) {
+    mock::advanceUs(1);
+    FakeHwTimer::tick();
+    periodic += hwTimers.expired(2);
+  }
+  CHECK(hwCallbacks == 3);
+  CHECK(periodic == 19);
+  CHECK(hwTimers.expired(1) and not hwTimers.expired(1));
+  hwTimers.stop(2);
+  CHECK(not FakeHwTimer::s_armed);
+}
+
+TEST_CASE(clock64)
+{
+  typedef ew::BasicClock64<check::Millis32Clock> Clock;
+  BasicTimer<Clock> t(5ULL << 32);
+  t.start();
+  for (int i = 0; i < 24; i++) {
+    CHECK(Clock::now() == millis());
+    CHECK(t.expired() == (i == 20));
+    mock::advanceMs(1UL << 30);
+    mock::advanceMs(i);
+  }
+  CHECK(Clock::now() == millis() and millis() > (6ULL << 32));
+  CHECK(Clock::toMs(Clock::fromMs(1234)) == 1234 and Clock::seconds() == millis() / 1000);
+
+  String s;
+  ew::fmtElapsed(s, 5000000000ULL);
+  CHECK_STR(s.c_str(), "57870d 08h 53m 20s");
+  StringPrint o;
+  ew::prtElapsed(o, 100000ULL * 86400 + 3661);
+  CHECK_STR(o.str, "100000d 01h 01m 01s");
+}
+
+TEST_CASE(timerDispatcher)
+{
+  ew::TimerDispatcher<4> timers;
+  static std::vector<int> calls;
+  calls.clear();
+  auto record = [](void *ctx) { calls.push_back(*static_cast<int *>(ctx)); };
+  int ids[4] = {0, 1, 2, 3};
+  auto a = timers.add(record, &ids[0]);
+  auto b = timers.add(record, &ids[1]);
+  auto c = timers.add(record, &ids[2]);
+  auto d = timers.add(record, &ids[3]);
+  CHECK(a == 0 and d == 3 and timers.add(record) == timers.None);
+  timers.start(a, 30);
+  timers.start(b, 10, TimerModes::Periodic);
+  timers.start(c, 20);
+  CHECK(timers.remaining() == 11);
+  mock::advanceMs(31);
+  CHECK(timers.run() == 3);
+  CHECK((calls == std::vector<int>{1, 2, 0}));
+  CHECK(timers.running(b) and not timers.running(a));
+  timers.remove(b);
+  CHECK(timers.add(record, &ids[1]) == b and timers.remaining() == timers.queue().remaining());
+  mock::advanceMs(100);
+  CHECK(timers.run() == 0 and calls.size() == 3);
+}
+
+TEST_CASE(tickContext)
+{
+  CHECK(ew::Tick::update() == 0);
+  Timer t(10);
+  ShortTimer s(10);
+  struct Task : PeriodicalBase<Task, ew::Tick>
+  {
+    Task() : PeriodicalBase<Task, ew::Tick>(5) {}
+    void task() { runs++; }
+    int runs = 0;
+  } task;
+  int runs = 0;
+  InlinePeriodical<> p(5, [&] { runs++; });
+  t.startAt(ew::Tick::now());
+  s.startAt(ew::Tick::now());
+  mock::advanceMs(20);
+  /* nothing moves until the next sample */
+  task.run();
+  CHECK(task.runs == 0 and task.remaining() == 6);
+  auto now = ew::Tick::update();
+  CHECK(now == 20 and ew::Tick::now() == 20);
+  task.run();
+  p.run(now);
+  CHECK(task.runs == 1 and runs == 1);
+  CHECK(t.remaining(now - 10) == 1 and t.expired(now) and not t.running());
+  CHECK(s.remaining(now) == 0 and s.expired(now));
+}
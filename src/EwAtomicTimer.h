@@ -0,0 +1,222 @@
+/* Timer which can be started and stopped from interrupts
+ *
+ * EwAtomicTimer.h
+ *
+ *  Created on: Oct 14, 2026
+ */
+
+#pragma once
+
+#include "EwUtil.h"
+
+namespace ew {
+
+/** Timer which may be armed and stopped from an ISR while the main loop
+ * polls it, without the main loop ever disabling interrupts.
+ *
+ * start() and stop() publish the new state under a sequence counter, all
+ * readers retry until they got a consistent copy. An ISR uses
+ * startFromIsr() and stopFromIsr() which do not touch the interrupt mask
+ * at all. start() and stop() from the main loop disable interrupts for the
+ * handful of stores only, to keep an ISR from interleaving its own. All
+ * the state expired() changes lives on the main loop's side, so polling a
+ * timer never writes anything an ISR sees.
+ *
+ * Arm a timer from a single interrupt priority only, on the ESP32 it may
+ * be armed from either core. Restarts are counted in 32 bits, a restart is
+ * only missed if 2^32 of them happen between two polls.
+ *
+ * @code{.cpp}
+    ew::AtomicTimer debounce(20);
+
+    void onPinChange()
+    {
+      debounce.startFromIsr();
+    }
+    void loop()
+    {
+      if (debounce.expired()) {
+        readPin();
+      }
+    }
+   @endcode
+ */
+template <class ClockT>
+class BasicAtomicTimer
+  : public TimerModes
+{
+public:
+  typedef ClockT Clock;
+  typedef typename Clock::Ticks Ticks;
+
+  BasicAtomicTimer(Ticks timeout = 0, Mode mode = OneShot)
+    : m_seq(0)
+    , m_gen(0)
+    , m_running(false)
+    , m_mode(mode)
+    , m_timeout(timeout)
+    , m_start(0)
+    , m_seenGen(0)
+    , m_fired(false)
+    , m_last(0)
+  { }
+  BasicAtomicTimer(const BasicAtomicTimer &) = delete;
+  BasicAtomicTimer &operator=(const BasicAtomicTimer &) = delete;
+
+  /** Main loop side */
+  void start()
+  {
+    CriticalSection lock;
+    publish(true, m_timeout, Clock::now());
+  }
+  void start(Ticks timeout)
+  {
+    CriticalSection lock;
+    publish(true, timeout, Clock::now());
+  }
+  void stop()
+  {
+    CriticalSection lock;
+    publish(false, m_timeout, m_start);
+  }
+  void setTimeout(Ticks timeout)
+  {
+    CriticalSection lock;
+    publish(m_running, timeout, m_start);
+  }
+
+  /** ISR side */
+  void startFromIsr()
+  {
+    IsrCriticalSection lock;
+    publish(true, m_timeout, Clock::now());
+  }
+  void startFromIsr(Ticks timeout)
+  {
+    IsrCriticalSection lock;
+    publish(true, timeout, Clock::now());
+  }
+  void stopFromIsr()
+  {
+    IsrCriticalSection lock;
+    publish(false, m_timeout, m_start);
+  }
+
+  /** Polled from the main loop: true once per expiry, see Timer */
+  bool expired()
+  {
+    State s = snapshot();
+    sync(s);
+    if (not s.running or not s.timeout or m_fired) {
+      return false;
+    }
+    auto now = Clock::now();
+    if (now - m_last <= s.timeout) {
+      return false;
+    }
+    if (m_mode == OneShot) {
+      m_fired = true;
+    } else {
+      m_last = now;
+    }
+    return true;
+  }
+  bool running() const
+  {
+    State s = snapshot();
+    return s.running and not (s.gen == m_seenGen and m_fired);
+  }
+  Ticks getTimeout() const
+  {
+    return snapshot().timeout;
+  }
+  /** Set the mode before the timer is shared with an ISR */
+  void setMode(Mode mode)
+  {
+    m_mode = mode;
+  }
+  /** Ticks until the timer expires, zero if it has expired and Never if
+   * it is stopped or has no timeout.
+   */
+  Ticks remaining() const
+  {
+    State s = snapshot();
+    if (not s.running or not s.timeout) {
+      return TickTraits<Ticks>::Never;
+    }
+    Ticks last = s.start;
+    if (s.gen == m_seenGen) {
+      if (m_fired) {
+        return TickTraits<Ticks>::Never;
+      }
+      last = m_last;
+    }
+    auto elapsed = Clock::now() - last;
+    return elapsed > s.timeout ? 0 : s.timeout - elapsed + 1;
+  }
+private:
+  struct State
+  {
+    uint32_t gen;
+    bool running;
+    Ticks timeout;
+    Ticks start;
+  };
+  /** Writer side of the sequence lock, called with writers excluded */
+  void publish(bool running, Ticks timeout, Ticks start)
+  {
+    uint8_t seq = m_seq;
+    __atomic_store_n(&m_seq, static_cast<uint8_t>(seq + 1), __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    m_running = running;
+    m_timeout = timeout;
+    if (running) {
+      m_start = start;
+      m_gen = m_gen + 1;
+    }
+    __atomic_store_n(&m_seq, static_cast<uint8_t>(seq + 2), __ATOMIC_RELEASE);
+  }
+  State snapshot() const
+  {
+    State s;
+    uint8_t seq;
+    do {
+      seq = __atomic_load_n(&m_seq, __ATOMIC_ACQUIRE);
+      s.gen = m_gen;
+      s.running = m_running;
+      s.timeout = m_timeout;
+      s.start = m_start;
+      __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    } while ((seq & 1) or seq != __atomic_load_n(&m_seq, __ATOMIC_RELAXED));
+    return s;
+  }
+  /** Picks up a restart published since the last poll */
+  void sync(const State &s)
+  {
+    if (s.gen != m_seenGen) {
+      m_seenGen = s.gen;
+      m_last = s.start;
+      m_fired = false;
+    }
+  }
+
+  /* shared with ISRs, written under m_seq */
+  uint8_t m_seq;
+  volatile uint32_t m_gen;
+  volatile bool m_running;
+  uint8_t m_mode;
+  volatile Ticks m_timeout;
+  volatile Ticks m_start;
+
+  /* main loop only */
+  uint32_t m_seenGen;
+  bool m_fired;
+  Ticks m_last;
+};
+
+/** Millisecond timer safe to arm from interrupts */
+typedef BasicAtomicTimer<MillisClock> AtomicTimer;
+/** Microsecond timer safe to arm from interrupts */
+typedef BasicAtomicTimer<MicrosClock> AtomicMicroTimer;
+
+} // namespace ew
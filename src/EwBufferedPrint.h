@@ -0,0 +1,137 @@
+/* Print adapter batching small writes into bulk writes
+ *
+ * EwBufferedPrint.h
+ *
+ *  Created on: Oct 14, 2026
+ */
+
+#pragma once
+
+#include "EwUtil.h"
+
+namespace ew {
+
+/** Print collecting everything printed to it in a buffer of N bytes and
+ * passing it on to the wrapped Print in a single write(buf, len).
+ *
+ * The buffer is flushed when it is full, on flush(), on destruction and,
+ * if line buffered, after every write containing a newline. Chained
+ * operator<< output thus reaches e.g. a WiFiClient as one packet instead
+ * of one per item:
+ *
+ * @code{.cpp}
+    void report(Print &prt)
+    {
+      ew::BufferedPrint<64> out(prt);
+      out << "a=" << a << " b=" << b << "\r\n";
+    }
+   @endcode
+ *
+ * Bytes the wrapped Print did not accept are kept and retried on the
+ * next flush. Writes which do not fit into a full buffer are dropped and
+ * reported through the return value as usual.
+ */
+template <size_t N = 64>
+class BufferedPrint
+  : public Print
+{
+  static_assert(N > 0, "BufferedPrint needs a buffer");
+public:
+  BufferedPrint(Print &out, bool lineBuffered = true)
+    : m_out(out)
+    , m_len(0)
+    , m_lineBuffered(lineBuffered)
+  { }
+  ~BufferedPrint()
+  {
+    flush();
+  }
+  BufferedPrint(const BufferedPrint &) = delete;
+  BufferedPrint &operator=(const BufferedPrint &) = delete;
+
+  size_t write(uint8_t c) override
+  {
+    if (m_len == N) {
+      flush();
+      if (m_len == N) {
+        return 0;
+      }
+    }
+    m_buf[m_len++] = c;
+    if (m_len == N or (c == '\n' and m_lineBuffered)) {
+      flush();
+    }
+    return 1;
+  }
+  size_t write(const uint8_t *buf, size_t len) override
+  {
+    size_t done = 0;
+    bool newline = m_lineBuffered and memchr(buf, '\n', len);
+    while (done < len) {
+      if (m_len == N) {
+        flush();
+        if (m_len == N) {
+          break;
+        }
+      }
+      if (not m_len and len - done >= N) {
+        /* nothing to batch with, hand it on as is */
+        return done + m_out.write(buf + done, len - done);
+      }
+      size_t chunk = N - m_len < len - done ? N - m_len : len - done;
+      memcpy(m_buf + m_len, buf + done, chunk);
+      m_len += chunk;
+      done += chunk;
+    }
+    if (newline or m_len == N) {
+      flush();
+    }
+    return done;
+  }
+  using Print::write;
+
+  /** Writes the buffered bytes to the wrapped Print */
+  void flush()
+  {
+    if (not m_len) {
+      return;
+    }
+    size_t n = m_out.write(m_buf, m_len);
+    if (n < m_len) {
+      memmove(m_buf, m_buf + n, m_len - n);
+    }
+    m_len -= n;
+  }
+  /** Discards the buffered bytes */
+  void clear()
+  {
+    m_len = 0;
+  }
+  int availableForWrite()
+  {
+    return N - m_len;
+  }
+  size_t pending() const
+  {
+    return m_len;
+  }
+  static constexpr size_t capacity()
+  {
+    return N;
+  }
+  void setLineBuffered(bool lineBuffered)
+  {
+    m_lineBuffered = lineBuffered;
+  }
+  bool getLineBuffered() const
+  {
+    return m_lineBuffered;
+  }
+private:
+  Print &m_out;
+  uint8_t m_buf[N];
+  size_t m_len;
+  bool m_lineBuffered;
+};
+
+} // namespace ew
@@ -0,0 +1,104 @@
+/* 64-bit clocks which never roll over
+ *
+ * EwClock64.h
+ *
+ *  Created on: Oct 14, 2026
+ */
+
+#pragma once
+
+#include "EwUtil.h"
+
+namespace ew {
+
+/** Extends the 32-bit ticks of BaseClockT to 64 bits, see Millis64Clock
+ * and Micros64Clock. The 32-bit milliseconds wrap after 49.7 days, their
+ * 64-bit extension after 584 million years.
+ *
+ * The clock counts the half periods of the base clock. A read compares the
+ * top bit of the base ticks with the parity of that count and, on a
+ * mismatch, knows the base clock has entered the next half period and
+ * advances the count. Reads don't lock, the count is published under a
+ * sequence counter, and are safe from ISRs where CriticalSection is and on
+ * both ESP32 cores. Only the one read per half period which advances the
+ * count disables interrupts for a few instructions.
+ *
+ * The clock has to be read at least once per half period of its base
+ * clock, every 24.8 days for milliseconds and every 35 minutes for
+ * microseconds, which any timer or periodical polled on it does.
+ *
+ * Use it as clock policy for timers and periodicals scheduled beyond the
+ * 32-bit horizon, and for uptimes:
+ *
+ * @code{.cpp}
+    ew::BasicTimer<ew::Millis64Clock> yearly(365ULL * 24 * 3600 * 1000);
+    ...
+    fmtElapsed(str, ew::Millis64Clock::seconds());
+   @endcode
+ */
+template <class BaseClockT>
+struct BasicClock64
+{
+  typedef uint64_t Ticks;
+
+  static Ticks now()
+  {
+    State &s = state();
+    uint32_t half;
+    uint8_t seq;
+    do {
+      seq = __atomic_load_n(&s.seq, __ATOMIC_ACQUIRE);
+      half = s.half;
+      __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    } while ((seq & 1) or seq != __atomic_load_n(&s.seq, __ATOMIC_RELAXED));
+    /* read after the count, so the base ticks are never older than it */
+    uint32_t lo = static_cast<uint32_t>(BaseClockT::now());
+    if ((half ^ (lo >> 31)) & 1) {
+      half = advance(half);
+    }
+    return (static_cast<Ticks>(half >> 1) << 32) | lo;
+  }
+  static Ticks fromMs(unsigned long ms)  { return static_cast<Ticks>(BaseClockT::fromMs(1)) * ms; }
+  static unsigned long toMs(Ticks t)     { return t / BaseClockT::fromMs(1); }
+  static unsigned long toUs(Ticks t)     { return t * 1000UL / BaseClockT::fromMs(1); }
+  /** Seconds since boot, e.g. for fmtElapsed() */
+  static uint64_t seconds()
+  {
+    return now() / (BaseClockT::fromMs(1) * 1000UL);
+  }
+private:
+  struct State
+  {
+    uint8_t seq;
+    volatile uint32_t half;
+  };
+  static State &state()
+  {
+    static State s_state = {0, 0};
+    return s_state;
+  }
+  /** Moves the count on from half unless someone else already did */
+  static uint32_t advance(uint32_t half)
+  {
+    State &s = state();
+    CriticalSection lock;
+    if (s.half == half) {
+      uint8_t seq = s.seq;
+      __atomic_store_n(&s.seq, static_cast<uint8_t>(seq + 1), __ATOMIC_RELAXED);
+      __atomic_thread_fence(__ATOMIC_RELEASE);
+      s.half = half + 1;
+      __atomic_store_n(&s.seq, static_cast<uint8_t>(seq + 2), __ATOMIC_RELEASE);
+    }
+    return half + 1;
+  }
+};
+
+/** 64-bit milliseconds since boot */
+typedef BasicClock64<MillisClock> Millis64Clock;
+/** 64-bit microseconds since boot */
+typedef BasicClock64<MicrosClock> Micros64Clock;
+
+/** Millisecond timer without the 49.7 day horizon */
+typedef BasicTimer<Millis64Clock> Timer64;
+
+} // namespace ew
@@ -0,0 +1,389 @@
+/* Compact binary encoding of telemetry
+ *
+ * EwEncode.h
+ *
+ *  Created on: Oct 14, 2026
+ */
+
+#pragma once
+
+#include "EwUtil.h"
+
+namespace ew {
+
+/** Print writing into a byte buffer supplied by the caller. Unlike
+ * FixedString it keeps zero bytes and has no terminating zero, so it takes
+ * binary output. Whatever does not fit is dropped and flagged by
+ * overflowed() until the next clear().
+ */
+class BytePrint
+  : public Print
+{
+public:
+  BytePrint(uint8_t *buf, size_t size)
+    : m_buf(buf)
+    , m_size(size)
+    , m_len(0)
+    , m_overflowed(false)
+  {}
+  size_t write(uint8_t c) override
+  {
+    if (m_len >= m_size) {
+      m_overflowed = true;
+      return 0;
+    }
+    m_buf[m_len++] = c;
+    return 1;
+  }
+  size_t write(const uint8_t *buf, size_t len) override
+  {
+    size_t room = m_size - m_len;
+    if (len > room) {
+      len = room;
+      m_overflowed = true;
+    }
+    memcpy(m_buf + m_len, buf, len);
+    m_len += len;
+    return len;
+  }
+  using Print::write;
+
+  void clear()
+  {
+    m_len = 0;
+    m_overflowed = false;
+  }
+  const uint8_t *data() const
+  {
+    return m_buf;
+  }
+  size_t length() const
+  {
+    return m_len;
+  }
+  size_t capacity() const
+  {
+    return m_size;
+  }
+  bool overflowed() const
+  {
+    return m_overflowed;
+  }
+private:
+  uint8_t *m_buf;
+  size_t m_size;
+  size_t m_len;
+  bool m_overflowed;
+};
+
+/** BytePrint with N bytes of storage of its own */
+template <size_t N>
+class ByteBuffer
+  : public BytePrint
+{
+public:
+  ByteBuffer()
+    : BytePrint(m_storage, N)
+  {}
+private:
+  uint8_t m_storage[N];
+};
+
+namespace detail {
+
+template <class I, bool Signed = (I(-1) < I(0))>
+struct Sign
+{
+  static bool negative(I v) { return v < 0; }
+};
+template <class I>
+struct Sign<I, false>
+{
+  static bool negative(I) { return false; }
+};
+
+/** Fixed-point values have at most nine decimals */
+inline uint8_t
+clampDecimals(uint8_t decimals)
+{
+  return decimals < 9 ? decimals : 9;
+}
+
+/** Rounds v * 10^decimals to the nearest integer, saturating at the range
+ * of long, nan gives 0
+ */
+inline long
+scaleDecimal(float v, uint8_t decimals)
+{
+  static const float Pow10[] = {1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f, 1e8f, 1e9f};
+  v *= Pow10[clampDecimals(decimals)];
+  v = v < 0 ? v - 0.5f : v + 0.5f;
+  /* float(LONG_MAX) rounds up to a power of two, just beyond the range */
+  if (v >= static_cast<float>(LONG_MAX)) {
+    return LONG_MAX;
+  }
+  if (v <= static_cast<float>(LONG_MIN)) {
+    return LONG_MIN;
+  }
+  return v == v ? static_cast<long>(v) : 0;
+}
+
+} // namespace detail
+
+/** Writes integers as variable length (LEB128) integers, signed ones
+ * zigzag encoded, to a Print: values below 128 take one byte, a 32-bit
+ * uptime in seconds rarely more than four.
+ *
+ * Fixed-point values are sent as zigzag varint of the value scaled by
+ * 10^decimals, 21.37 with two decimals as 2137 in two bytes. A failed
+ * write of the sink is remembered by failed().
+ *
+ * @code{.cpp}
+    ew::ByteBuffer<32> frame;
+    ew::Encoder enc(frame);
+    enc.varint(millis() / 1000).zigzag(rssi).fixed(temperature, 2);
+    lora.send(frame.data(), frame.length());
+   @endcode
+ */
+class Encoder
+{
+public:
+  Encoder(Print &prt)
+    : m_prt(prt)
+    , m_length(0)
+    , m_failed(false)
+  {}
+  /** Unsigned integer as varint */
+  template <class U>
+  Encoder &varint(U v)
+  {
+    static_assert(U(-1) > U(0), "varint() takes unsigned integers, use zigzag()");
+    typename detail::UInt32Or64<sizeof(U)>::type u = v;
+    uint8_t buf[10];
+    size_t n = 0;
+    while (u >= 0x80) {
+      buf[n++] = static_cast<uint8_t>(u) | 0x80;
+      u >>= 7;
+    }
+    buf[n++] = static_cast<uint8_t>(u);
+    return bytes(buf, n);
+  }
+  /** Signed integer zigzag encoded as varint, small magnitudes take few
+   * bytes regardless of the sign
+   */
+  template <class S>
+  Encoder &zigzag(S v)
+  {
+    static_assert(S(1) / S(2) == 0, "zigzag() takes integers, use fixed()");
+    typedef typename detail::UInt32Or64<sizeof(S)>::type U;
+    U u = static_cast<U>(v);
+    return varint(detail::Sign<S>::negative(v) ? ~(u << 1) : u << 1);
+  }
+  /** Fixed-point value: v * 10^decimals rounded and zigzag encoded, at
+   * most nine decimals and saturated at the range of long
+   */
+  Encoder &fixed(float v, uint8_t decimals)
+  {
+    return zigzag(detail::scaleDecimal(v, decimals));
+  }
+  Encoder &u8(uint8_t v)
+  {
+    return bytes(&v, 1);
+  }
+  Encoder &le16(uint16_t v)
+  {
+    uint8_t buf[2] = {uint8_t(v), uint8_t(v >> 8)};
+    return bytes(buf, sizeof(buf));
+  }
+  Encoder &le32(uint32_t v)
+  {
+    uint8_t buf[4] = {uint8_t(v), uint8_t(v >> 8), uint8_t(v >> 16), uint8_t(v >> 24)};
+    return bytes(buf, sizeof(buf));
+  }
+  /** String prefixed with its varint length */
+  Encoder &string(const char *str)
+  {
+    size_t len = str ? strlen(str) : 0;
+    varint(len);
+    return bytes(str, len);
+  }
+  /** Raw bytes */
+  Encoder &bytes(const void *buf, size_t len)
+  {
+    if (len) {
+      size_t n = m_prt.write(static_cast<const uint8_t *>(buf), len);
+      m_length += n;
+      m_failed = m_failed or n != len;
+    }
+    return *this;
+  }
+  /** Bytes written so far */
+  size_t length() const
+  {
+    return m_length;
+  }
+  bool failed() const
+  {
+    return m_failed;
+  }
+private:
+  Print &m_prt;
+  size_t m_length;
+  bool m_failed;
+};
+
+/** Writes the subset of CBOR (RFC 8949) telemetry needs: integers, texts,
+ * byte strings, booleans, null, single precision floats and decimal
+ * fractions in arrays and maps of known size.
+ *
+ * A record is a map whose keys are small integers from a schema shared
+ * with the ingest side, each key then takes a single byte and any CBOR
+ * library decodes the records:
+ *
+ * @code{.cpp}
+    enum Field { Uptime, Rssi, Temperature, Status };
+
+    ew::CborWriter rec(lora);
+    rec.map(4)
+       .field(Uptime, millis() / 1000)
+       .field(Rssi, rssi)
+       .field(Temperature, temperature, 2)
+       .field(Status, "ok");
+   @endcode
+ */
+class CborWriter
+{
+public:
+  CborWriter(Print &prt)
+    : m_enc(prt)
+  {}
+  CborWriter &array(size_t n)
+  {
+    return head(4, n);
+  }
+  CborWriter &map(size_t n)
+  {
+    return head(5, n);
+  }
+  /** Any signed or unsigned integer */
+  template <class I>
+  CborWriter &integer(I v)
+  {
+    static_assert(I(1) / I(2) == 0, "integer() takes integers, use float32() or fixed()");
+    typedef typename detail::UInt32Or64<sizeof(I)>::type U;
+    return detail::Sign<I>::negative(v) ? head(1, ~static_cast<U>(v)) : head(0, static_cast<U>(v));
+  }
+  CborWriter &text(const char *str)
+  {
+    size_t len = str ? strlen(str) : 0;
+    head(3, len);
+    m_enc.bytes(str, len);
+    return *this;
+  }
+  CborWriter &bytes(const void *buf, size_t len)
+  {
+    head(2, len);
+    m_enc.bytes(buf, len);
+    return *this;
+  }
+  CborWriter &boolean(bool v)
+  {
+    m_enc.u8(v ? 0xF5 : 0xF4);
+    return *this;
+  }
+  CborWriter &null()
+  {
+    m_enc.u8(0xF6);
+    return *this;
+  }
+  CborWriter &float32(float v)
+  {
+    static_assert(sizeof(float) == 4, "float32() needs IEEE single precision floats");
+    uint32_t u;
+    memcpy(&u, &v, sizeof(u));
+    uint8_t buf[5] = {0xFA, uint8_t(u >> 24), uint8_t(u >> 16), uint8_t(u >> 8), uint8_t(u)};
+    m_enc.bytes(buf, sizeof(buf));
+    return *this;
+  }
+  /** Decimal fraction mantissa * 10^exponent (tag 4) */
+  CborWriter &decimal(long mantissa, int8_t exponent)
+  {
+    head(6, 4);
+    array(2);
+    integer(exponent);
+    return integer(mantissa);
+  }
+  /** v with the given number of decimals, at most nine, as decimal
+   * fraction. The mantissa saturates at the range of long.
+   */
+  CborWriter &fixed(float v, uint8_t decimals)
+  {
+    decimals = detail::clampDecimals(decimals);
+    return decimal(detail::scaleDecimal(v, decimals), -static_cast<int8_t>(decimals));
+  }
+
+  template <class I>
+  CborWriter &field(unsigned int key, I v)
+  {
+    return integer(key).integer(v);
+  }
+  CborWriter &field(unsigned int key, bool v)
+  {
+    return integer(key).boolean(v);
+  }
+  CborWriter &field(unsigned int key, float v)
+  {
+    return integer(key).float32(v);
+  }
+  CborWriter &field(unsigned int key, float v, uint8_t decimals)
+  {
+    return integer(key).fixed(v, decimals);
+  }
+  CborWriter &field(unsigned int key, const char *str)
+  {
+    return integer(key).text(str);
+  }
+
+  size_t length() const
+  {
+    return m_enc.length();
+  }
+  bool failed() const
+  {
+    return m_enc.failed();
+  }
+private:
+  template <class U>
+  CborWriter &head(uint8_t major, U v)
+  {
+    uint8_t buf[9];
+    uint8_t n;
+    major <<= 5;
+    if (v < 24) {
+      buf[0] = major | static_cast<uint8_t>(v);
+      n = 1;
+    } else if (v <= 0xFF) {
+      buf[0] = major | 24;
+      n = 2;
+    } else if (v <= 0xFFFF) {
+      buf[0] = major | 25;
+      n = 3;
+    } else if ((v >> 16 >> 16) == 0) {
+      buf[0] = major | 26;
+      n = 5;
+    } else {
+      buf[0] = major | 27;
+      n = 9;
+    }
+    for (uint8_t i = n - 1; i > 0; i--) {
+      buf[i] = static_cast<uint8_t>(v);
+      v = v >> 8;
+    }
+    m_enc.bytes(buf, n);
+    return *this;
+  }
+
+  Encoder m_enc;
+};
+
+} // namespace ew
@@ -0,0 +1,387 @@
+/* Debouncing, rate limiting and coalescing of many inputs
+ *
+ * EwEventFilters.h
+ *
+ *  Created on: Oct 14, 2026
+ */
+
+#pragma once
+
+#include "EwUtil.h"
+
+namespace ew {
+namespace detail {
+
+/** N flags packed into bytes */
+template <size_t N>
+class BitBank
+{
+public:
+  static const size_t NumBytes = (N + 7) / 8;
+
+  BitBank()
+  {
+    fill(false);
+  }
+  bool get(size_t i) const
+  {
+    return m_bits[i >> 3] & mask(i);
+  }
+  void set(size_t i, bool v)
+  {
+    if (v) {
+      m_bits[i >> 3] |= mask(i);
+    } else {
+      m_bits[i >> 3] &= ~mask(i);
+    }
+  }
+  void fill(bool v)
+  {
+    for (auto &b : m_bits) {
+      b = v ? 0xFF : 0;
+    }
+  }
+  uint8_t byte(size_t i) const
+  {
+    return m_bits[i];
+  }
+private:
+  static uint8_t mask(size_t i)
+  {
+    return uint8_t(1) << (i & 7);
+  }
+  uint8_t m_bits[NumBytes];
+};
+
+/** The 16-bit time stamps of N inputs, the low bits of the clock ticks.
+ * Distances between a stamp and now are exact as long as they stay below
+ * MaxDelta = 32767 ticks.
+ */
+template <size_t N, class ClockT>
+class StampBank
+{
+public:
+  typedef typename ClockT::Ticks Ticks;
+  typedef uint16_t Stamp;
+  typedef TickTraits<Stamp> Traits;
+
+  StampBank()
+  {
+    for (auto &s : m_stamps) {
+      s = 0;
+    }
+  }
+  static Stamp stamp(Ticks now)
+  {
+    return static_cast<Stamp>(now);
+  }
+  void mark(size_t i, Ticks now)
+  {
+    m_stamps[i] = stamp(now);
+  }
+  /** Ticks since input i was marked */
+  Stamp elapsed(size_t i, Ticks now) const
+  {
+    return static_cast<Stamp>(stamp(now) - m_stamps[i]);
+  }
+  Stamp &operator[](size_t i)
+  {
+    return m_stamps[i];
+  }
+private:
+  Stamp m_stamps[N];
+};
+
+} // namespace detail
+
+/* The filters below handle N inputs each, e.g. the pins of a port
+ * expander or the topics of a gateway, in a few bytes per input: a 16-bit
+ * time stamp and some bits. Windows and intervals are shared by all inputs
+ * of a filter and limited to 32767 ticks, 32 s on the millisecond clock.
+ * Every call takes an optional now for the tick context, see Tick.
+ *
+ * Each filter keeps its own StampBank. The stamps of the filters mark
+ * different events, the last raw edge, the start of a refill interval or
+ * the opening of a window. A stamp shared by two filters on the same
+ * input would be overwritten by the other one, so an input in two filters
+ * costs two stamps.
+ *
+ * The stamps wrap after 65536 ticks. An input not looked at for that long
+ * may look recent: its debouncing or coalescing then completes up to one
+ * window late, never early, and the rate limiter may hand out less than
+ * the full burst. Polling every input at least every 32767 - window
+ * ticks, e.g. with fireAll(), rules that out.
+ */
+
+/** Debounces N digital inputs: a new level is taken over once the raw
+ * input kept it for window ticks. Two bytes and two bits per input.
+ *
+ * @code{.cpp}
+    ew::Debouncer<16> keys(20);
+    ...
+    for (uint8_t i = 0; i < 16; i++) {
+      if (keys.update(i, expander.read(i)) and keys.state(i)) {
+        onKeyUp(i);
+      }
+    }
+   @endcode
+ */
+template <size_t N = 1, class ClockT = MillisClock>
+class Debouncer
+{
+  typedef detail::StampBank<N, ClockT> Stamps;
+public:
+  typedef ClockT Clock;
+  typedef typename Clock::Ticks Ticks;
+
+  Debouncer(uint16_t window, bool initial = false)
+    : m_window(window)
+  {
+    m_state.fill(initial);
+    m_raw.fill(initial);
+  }
+  /** Feeds the raw level of input i, returns true if the debounced state
+   * changed
+   */
+  bool update(size_t i, bool raw)
+  {
+    return update(i, raw, Clock::now());
+  }
+  bool update(size_t i, bool raw, Ticks now)
+  {
+    if (raw != m_raw.get(i)) {
+      m_raw.set(i, raw);
+      m_stamps.mark(i, now);
+      return false;
+    }
+    if (raw == m_state.get(i) or m_stamps.elapsed(i, now) < m_window) {
+      return false;
+    }
+    m_state.set(i, raw);
+    return true;
+  }
+  /** Debounced state of input i */
+  bool state(size_t i) const
+  {
+    return m_state.get(i);
+  }
+  void setWindow(uint16_t window)
+  {
+    m_window = window;
+  }
+  uint16_t getWindow() const
+  {
+    return m_window;
+  }
+  static constexpr size_t size()
+  {
+    return N;
+  }
+private:
+  Stamps m_stamps;
+  detail::BitBank<N> m_state;
+  detail::BitBank<N> m_raw;
+  uint16_t m_window;
+};
+
+/** Token bucket rate limiter for N inputs: every input may pass burst
+ * events at once and one more each interval ticks. Three bytes per input.
+ *
+ * The buckets refill when they are asked. An input asking again after a
+ * pause of more than 65535 ticks may, since the stamps wrap, get less
+ * than its full burst back, never more.
+ *
+ * @code{.cpp}
+    ew::RateLimiter<64> perClient(5, 1000);  // 5 at once, then 1 per second
+    ...
+    if (not perClient.allow(clientId)) {
+      return reject();
+    }
+   @endcode
+ */
+template <size_t N = 1, class ClockT = MillisClock>
+class RateLimiter
+{
+  typedef detail::StampBank<N, ClockT> Stamps;
+public:
+  typedef ClockT Clock;
+  typedef typename Clock::Ticks Ticks;
+
+  RateLimiter(uint8_t burst, uint16_t interval)
+    : m_burst(burst)
+    , m_interval(interval ? interval : 1)
+  {
+    for (auto &t : m_tokens) {
+      t = burst;
+    }
+  }
+  /** Takes a token of input i, returns false if there is none left */
+  bool allow(size_t i)
+  {
+    return allow(i, Clock::now());
+  }
+  bool allow(size_t i, Ticks now)
+  {
+    refill(i, now);
+    if (not m_tokens[i]) {
+      return false;
+    }
+    if (m_tokens[i]-- == m_burst) {
+      /* the interval starts with the first token taken from a full bucket */
+      m_stamps.mark(i, now);
+    }
+    return true;
+  }
+  /** Tokens input i has left */
+  uint8_t tokens(size_t i)
+  {
+    return tokens(i, Clock::now());
+  }
+  uint8_t tokens(size_t i, Ticks now)
+  {
+    refill(i, now);
+    return m_tokens[i];
+  }
+  static constexpr size_t size()
+  {
+    return N;
+  }
+private:
+  void refill(size_t i, Ticks now)
+  {
+    uint8_t &tokens = m_tokens[i];
+    if (tokens >= m_burst) {
+      return;
+    }
+    /* a pause of a burst of intervals can exceed MaxDelta, but up to
+     * 65535 ticks the unsigned distance still counts the earned tokens
+     */
+    uint16_t elapsed = m_stamps.elapsed(i, now);
+    uint16_t add = elapsed / m_interval;
+    if (not add) {
+      return;
+    }
+    if (add >= m_burst - tokens) {
+      tokens = m_burst;
+    } else {
+      tokens += add;
+      m_stamps[i] += add * m_interval;
+    }
+  }
+
+  Stamps m_stamps;
+  uint8_t m_tokens[N];
+  uint8_t m_burst;
+  uint16_t m_interval;
+};
+
+/** Merges the events of N inputs arriving within window ticks into one:
+ * the first post() of an input opens its window, everything posted until
+ * it closes is folded into it, and fire() returns true once when it
+ * closed. Two bytes and a bit per input.
+ *
+ * @code{.cpp}
+    ew::Coalescer<> publish(200);
+
+    void onUpdate()
+    {
+      state.update();
+      publish.post();
+    }
+    void loop()
+    {
+      if (publish.fire()) {
+        mqtt.publish(topic, state.json());
+      }
+    }
+   @endcode
+ */
+template <size_t N = 1, class ClockT = MillisClock>
+class Coalescer
+{
+  typedef detail::StampBank<N, ClockT> Stamps;
+public:
+  typedef ClockT Clock;
+  typedef typename Clock::Ticks Ticks;
+
+  Coalescer(uint16_t window)
+    : m_window(window)
+  {}
+  /** Records an event of input i */
+  void post(size_t i = 0)
+  {
+    post(i, Clock::now());
+  }
+  void post(size_t i, Ticks now)
+  {
+    if (not m_pending.get(i)) {
+      m_pending.set(i, true);
+      m_stamps.mark(i, now);
+    }
+  }
+  /** true once the window of input i closed */
+  bool fire(size_t i = 0)
+  {
+    return fire(i, Clock::now());
+  }
+  bool fire(size_t i, Ticks now)
+  {
+    if (not m_pending.get(i) or m_stamps.elapsed(i, now) < m_window) {
+      return false;
+    }
+    m_pending.set(i, false);
+    return true;
+  }
+  /** Calls f(i) for every input whose window closed and returns their
+   * number. Inputs without pending events are skipped eight at a time.
+   */
+  template <class Fn>
+  size_t fireAll(Fn &&f)
+  {
+    return fireAll(Clock::now(), f);
+  }
+  template <class Fn>
+  size_t fireAll(Ticks now, Fn &&f)
+  {
+    size_t n = 0;
+    for (size_t b = 0; b < detail::BitBank<N>::NumBytes; b++) {
+      if (not m_pending.byte(b)) {
+        continue;
+      }
+      for (size_t i = b * 8; i < b * 8 + 8 and i < N; i++) {
+        if (fire(i, now)) {
+          n++;
+          f(i);
+        }
+      }
+    }
+    return n;
+  }
+  bool pending(size_t i = 0) const
+  {
+    return m_pending.get(i);
+  }
+  /** Drops the pending events of input i */
+  void cancel(size_t i = 0)
+  {
+    m_pending.set(i, false);
+  }
+  void setWindow(uint16_t window)
+  {
+    m_window = window;
+  }
+  uint16_t getWindow() const
+  {
+    return m_window;
+  }
+  static constexpr size_t size()
+  {
+    return N;
+  }
+private:
+  Stamps m_stamps;
+  detail::BitBank<N> m_pending;
+  uint16_t m_window;
+};
+
+} // namespace ew
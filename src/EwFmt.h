@@ -0,0 +1,568 @@
+/* Type-safe printf-style formatting checked at compile time
+ *
+ * EwFmt.h
+ *
+ *  Created on: Oct 14, 2026
+ */
+
+#pragma once
+
+#include "EwUtil.h"
+
+/** Formats to prt like prtFmt() but checks the format string against the
+ * arguments at compile time and does not go through vsnprintf.
+ *
+ * @code{.cpp}
+    EW_PRT_FMT(Serial, "T=%4d.%01u C, id %08lx, %s\r\n", t / 10, t % 10, id, name);
+   @endcode
+ *
+ * The format has to be a string literal. A mismatch in the number of
+ * conversions or a conversion not matching its argument type fails to
+ * compile. Only the conversions actually used are pulled into the binary,
+ * so printf itself is not linked unless used elsewhere.
+ *
+ * Supported are the flags "-+ #0", a literal width and precision of up
+ * to 255 and the conversions d i u x X o c for integers, c for char, s for
+ * strings (const char*, String, FixedString), f F for floating point and p
+ * for pointers. Length modifiers are accepted and ignored as the argument
+ * types are known. '*' width and precision are not supported.
+ *
+ * The conversions are parsed at compile time into a table of FmtSpec,
+ * at runtime only the literal text is scanned for the next '%'.
+ *
+ * Floating point values are rendered here as well, not by
+ * Print::print(double), which prints "ovf" beyond 4294967040 and rounds
+ * differently. They match printf up to the precision of double: values of
+ * 2^64 and beyond print zeros past their first 20 digits and decimal
+ * places past the 18th print as zeros.
+ */
+#define EW_PRT_FMT(prt, format, ...)                                                 \
+  do {                                                                               \
+    typedef decltype(ew::detail::fmtArgTypes(__VA_ARGS__)) EwFmtTypes;               \
+    static_assert(ew::detail::FmtCheckList<EwFmtTypes>::ok(format),                  \
+                  "format string does not match the arguments");                     \
+    static_assert(ew::detail::fmtWidthsOk(format),                                   \
+                  "width or precision above 255 in format string");                  \
+    constexpr ew::detail::FmtSpecs<EwFmtTypes::size> ewFmtSpecs =                    \
+      ew::detail::fmtSpecs<EwFmtTypes::size>(format);                                \
+    ew::detail::fmtRun<0>(prt, format, format, ewFmtSpecs, ##__VA_ARGS__);           \
+  } while (0)
+
+namespace ew {
+
+namespace detail {
+
+/* type classification */
+
+enum FmtCategory
+{
+  FmtNone,
+  FmtInt,
+  FmtChar,
+  FmtFloat,
+  FmtStr,
+  FmtPtr,
+};
+
+template <FmtCategory C> struct FmtTag {};
+
+template <class T> struct FmtCat                      { static const FmtCategory value = FmtNone; };
+template <class T> struct FmtCat<T *>                 { static const FmtCategory value = FmtPtr; };
+template <> struct FmtCat<char *>                     { static const FmtCategory value = FmtStr; };
+template <> struct FmtCat<const char *>               { static const FmtCategory value = FmtStr; };
+template <> struct FmtCat<String>                     { static const FmtCategory value = FmtStr; };
+template <size_t N> struct FmtCat<FixedString<N> >    { static const FmtCategory value = FmtStr; };
+template <> struct FmtCat<char>                       { static const FmtCategory value = FmtChar; };
+template <> struct FmtCat<float>                      { static const FmtCategory value = FmtFloat; };
+template <> struct FmtCat<double>                     { static const FmtCategory value = FmtFloat; };
+#define EW_FMT_INT(T) template <> struct FmtCat<T>    { static const FmtCategory value = FmtInt; }
+EW_FMT_INT(bool);
+EW_FMT_INT(signed char);
+EW_FMT_INT(unsigned char);
+EW_FMT_INT(short);
+EW_FMT_INT(unsigned short);
+EW_FMT_INT(int);
+EW_FMT_INT(unsigned int);
+EW_FMT_INT(long);
+EW_FMT_INT(unsigned long);
+EW_FMT_INT(long long);
+EW_FMT_INT(unsigned long long);
+#undef EW_FMT_INT
+
+/** Decays arguments the way they are passed to fmt() */
+template <class T> struct FmtDecay                    { typedef T type; };
+template <class T> struct FmtDecay<const T>           { typedef typename FmtDecay<T>::type type; };
+template <class T> struct FmtDecay<T &>               { typedef typename FmtDecay<T>::type type; };
+template <class T> struct FmtDecay<T &&>              { typedef typename FmtDecay<T>::type type; };
+template <class T, size_t N> struct FmtDecay<T[N]>    { typedef const T *type; };
+template <class T, size_t N> struct FmtDecay<const T[N]> { typedef const T *type; };
+
+template <class... Args>
+struct FmtTypes
+{
+  static const size_t size = sizeof...(Args);
+};
+
+/** Only used in unevaluated context to collect the argument types */
+template <class... Args>
+FmtTypes<typename FmtDecay<Args>::type...> fmtArgTypes(Args &&...);
+
+/* compile time parser, C++11 constexpr style */
+
+constexpr bool fmtIsSkip(char c)
+{
+  return c == '-' or c == '+' or c == ' ' or c == '#' or c == '.'
+      or (c >= '0' and c <= '9')
+      or c == 'h' or c == 'l' or c == 'L' or c == 'z' or c == 'j' or c == 't';
+}
+constexpr const char *fmtConvChar(const char *s)
+{
+  return fmtIsSkip(*s) ? fmtConvChar(s + 1) : s;
+}
+/** Pointer behind the '%' of the next conversion or to the terminating
+ * zero if there is none.
+ */
+constexpr const char *fmtNextSpec(const char *s)
+{
+  return *s == '\0' ? s
+       : *s != '%'  ? fmtNextSpec(s + 1)
+       : s[1] == '%' ? fmtNextSpec(s + 2)
+       : s + 1;
+}
+/** Pointer to the conversion character of the next conversion or to the
+ * terminating zero if there is none.
+ */
+constexpr const char *fmtNextConv(const char *s)
+{
+  return fmtConvChar(fmtNextSpec(s));
+}
+constexpr bool fmtIn(char c, const char *set)
+{
+  return *set and (*set == c or fmtIn(c, set + 1));
+}
+constexpr bool fmtAccepts(FmtCategory cat, char conv)
+{
+  return cat == FmtInt   ? fmtIn(conv, "diuxXoc")
+       : cat == FmtChar  ? fmtIn(conv, "cdiuxXo")
+       : cat == FmtFloat ? fmtIn(conv, "fF")
+       : cat == FmtStr   ? conv == 's'
+       : cat == FmtPtr   ? conv == 'p'
+       : false;
+}
+
+/** Widths and precisions have to fit into a uint8_t */
+constexpr bool fmtWidthsOk(const char *s);
+constexpr bool fmtDigitsOk(const char *s, unsigned v, bool prec)
+{
+  return (*s >= '0' and *s <= '9') ? v * 10 + (*s - '0') <= 255
+                                     and fmtDigitsOk(s + 1, v * 10 + (*s - '0'), prec)
+       : (*s == '.' and not prec)  ? fmtDigitsOk(s + 1, 0, true)
+       : fmtWidthsOk(s);
+}
+constexpr bool fmtFlagsOk(const char *s)
+{
+  return fmtIn(*s, "-+ #0") ? fmtFlagsOk(s + 1) : fmtDigitsOk(s, 0, false);
+}
+constexpr bool fmtWidthsOk(const char *s)
+{
+  return *s == '\0'  ? true
+       : *s != '%'   ? fmtWidthsOk(s + 1)
+       : s[1] == '%' ? fmtWidthsOk(s + 2)
+       : fmtFlagsOk(s + 1);
+}
+
+template <class... Args> struct FmtCheck;
+
+template <>
+struct FmtCheck<>
+{
+  static constexpr bool ok(const char *s)
+  {
+    return *fmtNextConv(s) == '\0';
+  }
+};
+
+template <class A, class... Rest>
+struct FmtCheck<A, Rest...>
+{
+  static constexpr bool ok(const char *s)
+  {
+    return check(fmtNextConv(s));
+  }
+  static constexpr bool check(const char *conv)
+  {
+    return *conv != '\0'
+       and fmtAccepts(FmtCat<A>::value, *conv)
+       and FmtCheck<Rest...>::ok(conv + 1);
+  }
+};
+
+template <class List> struct FmtCheckList;
+template <class... Args>
+struct FmtCheckList<FmtTypes<Args...> >
+  : FmtCheck<Args...>
+{};
+
+/** One conversion and the offset of the format text following it */
+struct FmtSpec
+{
+  bool left, zero, plus, space, alt;
+  uint8_t width;
+  int16_t prec;
+  char conv;
+  uint16_t end;
+};
+
+constexpr bool fmtHasFlag(const char *s, char flag)
+{
+  return fmtIn(*s, "-+ #0") and (*s == flag or fmtHasFlag(s + 1, flag));
+}
+constexpr const char *fmtSkipFlags(const char *s)
+{
+  return fmtIn(*s, "-+ #0") ? fmtSkipFlags(s + 1) : s;
+}
+constexpr const char *fmtSkipDigits(const char *s)
+{
+  return (*s >= '0' and *s <= '9') ? fmtSkipDigits(s + 1) : s;
+}
+/** Width or precision at s, formats not checked at compile time saturate
+ * at 255
+ */
+constexpr unsigned fmtNumber(const char *s, unsigned v = 0)
+{
+  return (*s >= '0' and *s <= '9')
+       ? fmtNumber(s + 1, v * 10 + (*s - '0') < 255 ? v * 10 + (*s - '0') : 255)
+       : v;
+}
+constexpr int16_t fmtPrecision(const char *s)
+{
+  return *s == '.' ? static_cast<int16_t>(fmtNumber(s + 1)) : static_cast<int16_t>(-1);
+}
+/** Spec of the conversion behind the '%' at s in format f */
+constexpr FmtSpec fmtSpecAt(const char *f, const char *s)
+{
+  return FmtSpec{fmtHasFlag(s, '-'), fmtHasFlag(s, '0'), fmtHasFlag(s, '+'),
+                 fmtHasFlag(s, ' '), fmtHasFlag(s, '#'),
+                 static_cast<uint8_t>(fmtNumber(fmtSkipFlags(s))),
+                 fmtPrecision(fmtSkipDigits(fmtSkipFlags(s))),
+                 *fmtConvChar(s),
+                 static_cast<uint16_t>(fmtConvChar(s) - f + (*fmtConvChar(s) ? 1 : 0))};
+}
+/** Pointer behind the '%' of conversion k */
+constexpr const char *fmtNthSpec(const char *s, size_t k)
+{
+  return k == 0 or not *fmtNextSpec(s) ? fmtNextSpec(s)
+       : not *fmtConvChar(fmtNextSpec(s)) ? fmtConvChar(fmtNextSpec(s))
+       : fmtNthSpec(fmtConvChar(fmtNextSpec(s)) + 1, k - 1);
+}
+
+/** The specs of the first N conversions of a format */
+template <size_t N>
+struct FmtSpecs
+{
+  FmtSpec spec[N ? N : 1];
+};
+
+template <size_t... I> struct FmtIndices {};
+template <size_t N, size_t... I>
+struct FmtMakeIndices : FmtMakeIndices<N - 1, N - 1, I...> {};
+template <size_t... I>
+struct FmtMakeIndices<0, I...>
+{
+  typedef FmtIndices<I...> type;
+};
+
+constexpr FmtSpecs<0> fmtSpecs(const char *, FmtIndices<>)
+{
+  return FmtSpecs<0>{{}};
+}
+template <size_t... I>
+constexpr FmtSpecs<sizeof...(I)> fmtSpecs(const char *f, FmtIndices<I...>)
+{
+  return FmtSpecs<sizeof...(I)>{{fmtSpecAt(f, fmtNthSpec(f, I))...}};
+}
+template <size_t N>
+constexpr FmtSpecs<N> fmtSpecs(const char *f)
+{
+  return fmtSpecs(f, typename FmtMakeIndices<N>::type());
+}
+
+/* runtime */
+
+/** Writes literal text up to the next conversion and returns a pointer to
+ * its '%' or to the terminating zero.
+ */
+inline const char *
+fmtLiteral(Print &prt, const char *f)
+{
+  for (;;) {
+    const char *lit = f;
+    while (*f and *f != '%') {
+      f++;
+    }
+    if (f != lit) {
+      prt.write(reinterpret_cast<const uint8_t*>(lit), f - lit);
+    }
+    if (*f and f[1] == '%') {
+      prt.write('%');
+      f += 2;
+      continue;
+    }
+    return f;
+  }
+}
+
+inline void
+fmtPad(Print &prt, char c, size_t n)
+{
+  while (n--) {
+    prt.write(c);
+  }
+}
+
+/** Writes prefix, zeros and body padded to the width of spec */
+inline void
+fmtField(Print &prt, const FmtSpec &spec, const char *prefix, size_t prefixLen,
+         const char *body, size_t bodyLen, bool zeroPad, size_t zeros = 0)
+{
+  size_t len = prefixLen + zeros + bodyLen;
+  size_t pad = spec.width > len ? spec.width - len : 0;
+  if (not spec.left and not zeroPad) {
+    fmtPad(prt, ' ', pad);
+  }
+  prt.write(reinterpret_cast<const uint8_t*>(prefix), prefixLen);
+  if (not spec.left and zeroPad) {
+    fmtPad(prt, '0', pad);
+  }
+  fmtPad(prt, '0', zeros);
+  prt.write(reinterpret_cast<const uint8_t*>(body), bodyLen);
+  if (spec.left) {
+    fmtPad(prt, ' ', pad);
+  }
+}
+
+template <class U>
+inline void
+fmtInteger(Print &prt, const FmtSpec &spec, U mag, bool neg)
+{
+  char buf[3 * sizeof(U) + 1];
+  char *end = buf + sizeof(buf);
+  char *p = end;
+  unsigned base = spec.conv == 'x' or spec.conv == 'X' ? 16 : spec.conv == 'o' ? 8 : 10;
+  const char *digits = spec.conv == 'X' ? "0123456789ABCDEF" : "0123456789abcdef";
+  if (base == 10) {
+    if (mag) {
+      p = utoaRev(static_cast<typename UInt32Or64<sizeof(U)>::type>(mag), end);
+    }
+  } else {
+    for (U v = mag; v; v /= base) {
+      *--p = digits[v % base];
+    }
+  }
+  int minDigits = spec.prec < 0 ? 1 : spec.prec;
+  size_t zeros = minDigits > end - p ? minDigits - (end - p) : 0;
+  char prefix[2];
+  size_t prefixLen = 0;
+  if (neg) {
+    prefix[prefixLen++] = '-';
+  } else if (spec.plus and base == 10) {
+    prefix[prefixLen++] = '+';
+  } else if (spec.space and base == 10) {
+    prefix[prefixLen++] = ' ';
+  }
+  if (spec.alt and mag and base == 16) {
+    prefix[prefixLen++] = '0';
+    prefix[prefixLen++] = spec.conv;
+  } else if (spec.alt and base == 8 and not zeros and (p == end or *p != '0')) {
+    *--p = '0';
+  }
+  fmtField(prt, spec, prefix, prefixLen, p, end - p, spec.zero and spec.prec < 0, zeros);
+}
+
+/** Unsigned type of the same width, so negative values wrap like in printf */
+template <size_t Size> struct FmtUInt;
+template <> struct FmtUInt<1>                 { typedef uint8_t type; };
+template <> struct FmtUInt<2>                 { typedef uint16_t type; };
+template <> struct FmtUInt<4>                 { typedef uint32_t type; };
+template <> struct FmtUInt<8>                 { typedef uint64_t type; };
+
+template <class T>
+inline bool fmtNegative(T v)
+{
+  return static_cast<T>(-1) < static_cast<T>(0) and v < static_cast<T>(0);
+}
+
+template <class T>
+inline void
+fmtArg(Print &prt, const FmtSpec &spec, T v, FmtTag<FmtInt>)
+{
+  typedef typename FmtUInt<sizeof(T)>::type U;
+  if (spec.conv == 'c') {
+    char c = static_cast<char>(v);
+    fmtField(prt, spec, nullptr, 0, &c, 1, false);
+    return;
+  }
+  bool neg = (spec.conv == 'd' or spec.conv == 'i') and fmtNegative(v);
+  U mag = neg ? static_cast<U>(U(0) - static_cast<U>(v)) : static_cast<U>(v);
+  fmtInteger(prt, spec, mag, neg);
+}
+
+inline void
+fmtArg(Print &prt, const FmtSpec &spec, char c, FmtTag<FmtChar>)
+{
+  if (spec.conv == 'c') {
+    fmtField(prt, spec, nullptr, 0, &c, 1, false);
+  } else {
+    fmtArg(prt, spec, static_cast<int>(c), FmtTag<FmtInt>());
+  }
+}
+
+/** %f of v, rounding the last decimal place half to even like printf */
+inline void
+fmtFloat(Print &prt, const FmtSpec &spec, double v)
+{
+  char sign = '\0';
+  if (__builtin_signbit(v)) {
+    sign = '-';
+    v = -v;
+  } else if (spec.plus or spec.space) {
+    sign = spec.plus ? '+' : ' ';
+  }
+  if (v != v or v > 1.7976931348623157e308) {
+    const char *s = v != v ? (spec.conv == 'F' ? "NAN" : "nan")
+                           : (spec.conv == 'F' ? "INF" : "inf");
+    fmtField(prt, spec, &sign, sign ? 1 : 0, s, 3, false);
+    return;
+  }
+  /* values beyond 2^64 are scaled down, their tail printed as zeros */
+  size_t scale = 0;
+  while (v >= 18446744073709551616.0) {
+    v /= 10;
+    scale++;
+  }
+  size_t prec = spec.prec < 0 ? 6 : spec.prec;
+  size_t places = prec < 18 ? prec : 18;
+  uint64_t ip = static_cast<uint64_t>(v);
+  double frac = v - static_cast<double>(ip);
+  char decimals[18];
+  for (size_t i = 0; i < places; i++) {
+    frac *= 10;
+    uint8_t d = static_cast<uint8_t>(frac);
+    frac -= d;
+    decimals[i] = '0' + d;
+  }
+  bool odd = places ? decimals[places - 1] & 1 : ip & 1;
+  if (not scale and (frac > 0.5 or (frac == 0.5 and odd))) {
+    size_t i = places;
+    while (i and decimals[i - 1] == '9') {
+      decimals[--i] = '0';
+    }
+    if (i) {
+      decimals[i - 1]++;
+    } else {
+      ip++;
+    }
+  }
+  char digits[20];
+  char *end = digits + sizeof(digits);
+  char *p = utoaRev(ip, end);
+  bool point = prec or spec.alt;
+  size_t len = (sign ? 1 : 0) + (end - p) + scale + point + prec;
+  size_t pad = spec.width > len ? spec.width - len : 0;
+  if (not spec.left and not spec.zero) {
+    fmtPad(prt, ' ', pad);
+  }
+  if (sign) {
+    prt.write(sign);
+  }
+  if (not spec.left and spec.zero) {
+    fmtPad(prt, '0', pad);
+  }
+  prt.write(reinterpret_cast<const uint8_t*>(p), end - p);
+  fmtPad(prt, '0', scale);
+  if (point) {
+    prt.write('.');
+  }
+  prt.write(reinterpret_cast<const uint8_t*>(decimals), places);
+  fmtPad(prt, '0', prec - places);
+  if (spec.left) {
+    fmtPad(prt, ' ', pad);
+  }
+}
+
+template <class T>
+inline void
+fmtArg(Print &prt, const FmtSpec &spec, T v, FmtTag<FmtFloat>)
+{
+  fmtFloat(prt, spec, static_cast<double>(v));
+}
+
+inline const char *fmtStr(const char *s)           { return s ? s : "(null)"; }
+inline const char *fmtStr(const String &s)         { return s.c_str(); }
+template <size_t N>
+inline const char *fmtStr(const FixedString<N> &s) { return s.c_str(); }
+
+template <class T>
+inline void
+fmtArg(Print &prt, const FmtSpec &spec, const T &v, FmtTag<FmtStr>)
+{
+  const char *s = fmtStr(v);
+  size_t len = 0;
+  while (s[len] and (spec.prec < 0 or len < size_t(spec.prec))) {
+    len++;
+  }
+  fmtField(prt, spec, nullptr, 0, s, len, false);
+}
+
+template <class T>
+inline void
+fmtArg(Print &prt, const FmtSpec &spec, const T &v, FmtTag<FmtPtr>)
+{
+  FmtSpec hex = spec;
+  hex.conv = 'x';
+  hex.alt = true;
+  fmtInteger(prt, hex, reinterpret_cast<uintptr_t>(v), false);
+}
+
+/** Writes format f from at on, starting with conversion K of specs */
+template <size_t K, size_t N>
+inline void
+fmtRun(Print &prt, const char *, const char *at, const FmtSpecs<N> &)
+{
+  at = fmtLiteral(prt, at);
+  if (*at) {
+    /* conversion without argument */
+    prt.write(at);
+  }
+}
+
+template <size_t K, size_t N, class A, class... Rest>
+inline void
+fmtRun(Print &prt, const char *f, const char *at, const FmtSpecs<N> &specs,
+       const A &a, const Rest &... rest)
+{
+  at = fmtLiteral(prt, at);
+  if (not *at) {
+    return;
+  }
+  const FmtSpec &spec = specs.spec[K];
+  typedef typename FmtDecay<A>::type D;
+  fmtArg(prt, spec, static_cast<const D &>(a), FmtTag<FmtCat<D>::value>());
+  fmtRun<K + 1>(prt, f, f + spec.end, specs, rest...);
+}
+
+} // namespace detail
+
+/** Formats like EW_PRT_FMT, e.g. with a format which is not a literal.
+ * The format is then neither checked nor parsed at compile time, the
+ * table of conversions is built at runtime.
+ */
+template <class... Args>
+inline Print &
+fmt(Print &prt, const char *f, const Args &... args)
+{
+  detail::fmtRun<0>(prt, f, f, detail::fmtSpecs<sizeof...(Args)>(f), args...);
+  return prt;
+}
+
+} // namespace ew
@@ -0,0 +1,304 @@
+/* Interrupt driven timers multiplexed onto one hardware timer channel
+ *
+ * EwHwTimer.h
+ *
+ *  Created on: Oct 14, 2026
+ */
+
+#pragma once
+
+#include "EwTimerQueue.h"
+
+#if defined(ESP32)
+# include <esp_timer.h>
+#endif
+
+namespace ew {
+
+/* Hardware backends for HwTimerMux. A backend owns one compare channel and
+ * provides
+ *
+ *   typedef ... Clock;                               // clock of the deadlines
+ *   static void begin(void (*handler)(void *), void *ctx);
+ *   static void arm(unsigned long ticks);             // fire handler once
+ *   static void disarm();
+ *
+ * arm() replaces a previously armed expiry. Firing a little early is fine,
+ * the multiplexer simply re-arms for the rest.
+ */
+
+#if defined(__AVR__) && defined(TCCR1A)
+/** 16-bit Timer1 of the ATmega running free with a prescaler of 64, firing
+ * through compare channel A. Delays beyond its range of 65535 timer ticks
+ * (262 ms at 16 MHz) are reached in several steps.
+ *
+ * The interrupt vector can not be defined in a header, place
+ * EW_AVR_TIMER1_ISR() in exactly one of your source files.
+ */
+struct AvrTimer1
+{
+  typedef MicrosClock Clock;
+  static const unsigned long CpuKHz = F_CPU / 1000UL;
+  /** Longest delay in one step, 0xFFFF timer ticks. us * CpuKHz of it
+   * still fits into 32 bits.
+   */
+  static const unsigned long MaxUs = 0xFFFFUL * 64000UL / CpuKHz;
+
+  static void begin(void (*handler)(void *), void *ctx)
+  {
+    CriticalSection lock;
+    hook().handler = handler;
+    hook().ctx = ctx;
+    TCCR1A = 0;
+    TCCR1B = _BV(CS11) | _BV(CS10);
+    TIMSK1 &= ~_BV(OCIE1A);
+  }
+  static void arm(unsigned long us)
+  {
+    /* at least two timer ticks ahead so the match can't be missed, the
+     * clock need not be a whole number of MHz
+     */
+    unsigned long ticks = (us < MaxUs ? us : MaxUs) * CpuKHz / 64000UL + 2;
+    if (ticks > 0xFFFF) {
+      ticks = 0xFFFF;
+    }
+    CriticalSection lock;
+    TIFR1 = _BV(OCF1A);
+    OCR1A = TCNT1 + static_cast<uint16_t>(ticks);
+    TIMSK1 |= _BV(OCIE1A);
+  }
+  static void disarm()
+  {
+    TIMSK1 &= ~_BV(OCIE1A);
+  }
+  static void isr()
+  {
+    hook().handler(hook().ctx);
+  }
+private:
+  struct Hook
+  {
+    void (*handler)(void *);
+    void *ctx;
+  };
+  static Hook &hook()
+  {
+    static Hook s_hook = {nullptr, nullptr};
+    return s_hook;
+  }
+};
+
+# define EW_AVR_TIMER1_ISR() ISR(TIMER1_COMPA_vect) { ew::AvrTimer1::isr(); }
+#endif
+
+#if defined(ESP32)
+/** One esp_timer. Its callbacks run in the high priority esp_timer task,
+ * not in an ISR.
+ */
+struct Esp32Timer
+{
+  typedef MicrosClock Clock;
+
+  static void begin(void (*handler)(void *), void *ctx)
+  {
+    esp_timer_create_args_t args = {};
+    args.callback = handler;
+    args.arg = ctx;
+    args.name = "ew";
+    esp_timer_create(&args, &handle());
+  }
+  static void arm(unsigned long us)
+  {
+    esp_timer_stop(handle());
+    esp_timer_start_once(handle(), us);
+  }
+  static void disarm()
+  {
+    esp_timer_stop(handle());
+  }
+private:
+  static esp_timer_handle_t &handle()
+  {
+    static esp_timer_handle_t s_handle = nullptr;
+    return s_handle;
+  }
+};
+#endif
+
+/** Up to N logical timers sharing one hardware timer channel.
+ *
+ * The running timers are kept in a TimerQueue. The hardware channel is
+ * always armed for the earliest deadline, so nothing has to be polled and
+ * a timer fires within a few microseconds of its deadline. The timeouts
+ * are given in ticks of the backend's clock, i.e. microseconds for the
+ * backends above.
+ *
+ * A timer with a callback attached calls it from the backend's interrupt
+ * context. Keep it short, it may start and stop any timer. A timer
+ * without callback only flags its expiry for deferred handling by poll()
+ * or expired() in the main loop.
+ *
+ * @code{.cpp}
+    ew::HwTimerMux<ew::AvrTimer1, 4> hwTimers;
+    EW_AVR_TIMER1_ISR()
+
+    enum { Pulse, Watchdog };
+
+    void endPulse(void *)
+    {
+      digitalWrite(PulsePin, LOW);
+    }
+    void setup()
+    {
+      hwTimers.begin();
+      hwTimers.attach(Pulse, endPulse);
+    }
+    void loop()
+    {
+      ...
+      digitalWrite(PulsePin, HIGH);
+      hwTimers.start(Pulse, 350);
+      hwTimers.start(Watchdog, 100000);
+      if (hwTimers.expired(Watchdog)) {
+        ...
+      }
+    }
+   @endcode
+ *
+ * There can only be one multiplexer per backend.
+ */
+template <class Backend, size_t N>
+class HwTimerMux
+{
+public:
+  typedef typename Backend::Clock Clock;
+  typedef typename Clock::Ticks Ticks;
+  typedef TimerQueue<N, Clock> Queue;
+  typedef typename Queue::Id Id;
+  typedef typename Queue::Mode Mode;
+  typedef void (*Callback)(void *ctx);
+
+  HwTimerMux()
+  {
+    for (size_t i = 0; i < N; i++) {
+      m_callbacks[i] = Entry{nullptr, nullptr};
+      m_pending[i] = false;
+    }
+  }
+  HwTimerMux(const HwTimerMux &) = delete;
+  HwTimerMux &operator=(const HwTimerMux &) = delete;
+
+  void begin()
+  {
+    Backend::begin(&onExpiry, this);
+  }
+  /** Calls callback from interrupt context when timer id expires, a
+   * nullptr callback flags the expiry for poll() instead.
+   */
+  void attach(Id id, Callback callback, void *ctx = nullptr)
+  {
+    CriticalSection lock;
+    m_callbacks[id] = Entry{callback, ctx};
+  }
+  void start(Id id)
+  {
+    CriticalSection lock;
+    m_queue.start(id);
+    rearm();
+  }
+  void start(Id id, Ticks timeout, Mode mode = TimerModes::OneShot)
+  {
+    CriticalSection lock;
+    m_queue.start(id, timeout, mode);
+    rearm();
+  }
+  void stop(Id id)
+  {
+    CriticalSection lock;
+    m_queue.stop(id);
+    m_pending[id] = false;
+    rearm();
+  }
+  bool running(Id id) const
+  {
+    CriticalSection lock;
+    return m_queue.running(id);
+  }
+  /** true once after timer id expired without attached callback */
+  bool expired(Id id)
+  {
+    CriticalSection lock;
+    if (not m_pending[id]) {
+      return false;
+    }
+    m_pending[id] = false;
+    return true;
+  }
+  /** Calls f(id) for every timer flagged as expired since the last call
+   * and returns their number.
+   */
+  template <class Fn>
+  size_t poll(Fn &&f)
+  {
+    size_t n = 0;
+    for (size_t i = 0; i < N; i++) {
+      if (expired(i)) {
+        n++;
+        f(static_cast<Id>(i));
+      }
+    }
+    return n;
+  }
+private:
+  struct Entry
+  {
+    Callback callback;
+    void *ctx;
+  };
+  /** Arms the channel for the earliest deadline, called locked */
+  void rearm()
+  {
+    Ticks left = m_queue.remaining();
+    if (left == Queue::Traits::Never) {
+      Backend::disarm();
+    } else {
+      Backend::arm(left);
+    }
+  }
+  static void onExpiry(void *self)
+  {
+    static_cast<HwTimerMux *>(self)->service();
+  }
+  void service()
+  {
+    Id fired[N];
+    size_t n = 0;
+    {
+      CriticalSection lock;
+      m_queue.poll([&](Id id) {
+        fired[n++] = id;
+      });
+      rearm();
+    }
+    /* callbacks run unlocked so they can restart their timers */
+    for (size_t i = 0; i < n; i++) {
+      Entry e;
+      {
+        CriticalSection lock;
+        e = m_callbacks[fired[i]];
+        if (not e.callback) {
+          m_pending[fired[i]] = true;
+        }
+      }
+      if (e.callback) {
+        e.callback(e.ctx);
+      }
+    }
+  }
+
+  Queue m_queue;
+  Entry m_callbacks[N];
+  volatile bool m_pending[N];
+};
+
+} // namespace ew
@@ -0,0 +1,224 @@
+/* Load shedding for periodic tasks
+ *
+ * EwLoadGovernor.h
+ *
+ *  Created on: Oct 14, 2026
+ */
+
+#pragma once
+
+#include "EwUtil.h"
+
+namespace ew {
+
+/** Priority classes of adaptive tasks. Critical tasks always run at their
+ * nominal rate, under overload Low tasks are slowed down first and Normal
+ * tasks once the Low ones reached their largest maxFactor.
+ */
+struct LoadPriorities
+{
+  typedef enum {
+    Critical,
+    Normal,
+    Low,
+  } Priority;
+};
+
+/** Measures how long the main loop is busy per pass and derives by how
+ * much the periods of AdaptivePeriodicalBase tasks are stretched.
+ *
+ * The busy time between begin() and end() is averaged over the last few
+ * passes. Every AdjustMs the governor raises the stretch by one if the
+ * average exceeds the budget and lowers it by one once it fell below three
+ * quarters of it, Low tasks first. Sleeping in between, e.g. in the idle
+ * hook of a Scheduler, does not count.
+ *
+ * The stretch of a class never exceeds the largest maxFactor of the tasks
+ * registered in it, or MaxStretch, so no adjustment is wasted on a factor
+ * no task would follow: Normal tasks step in as soon as the Low ones can't
+ * shed any more, and recovery starts with a stretch that takes effect.
+ *
+ * @code{.cpp}
+    ew::LoadGovernor governor(2000);  // 2 ms per loop pass
+
+    void loop()
+    {
+      governor.begin();
+      motor.run();
+      housekeeping.run();
+      governor.end();
+    }
+   @endcode
+ */
+class LoadGovernor
+  : public LoadPriorities
+{
+public:
+  static const unsigned long AdjustMs = 100;
+  static const uint8_t MaxStretch = 16;
+
+  /** constexpr so a global governor is initialised before any task of
+   * another translation unit registers with it
+   */
+  constexpr LoadGovernor(unsigned long budgetUs)
+    : m_budgetUs(budgetUs)
+    , m_avgUs(0)
+    , m_start(0)
+    , m_lastAdjust(0)
+    , m_low(1)
+    , m_normal(1)
+    , m_maxLow(1)
+    , m_maxNormal(1)
+  {}
+  /** Called by the adaptive tasks: lets the stretch of priority grow up
+   * to maxFactor
+   */
+  void registerTask(Priority priority, uint8_t maxFactor)
+  {
+    uint8_t &max = priority == Low ? m_maxLow : m_maxNormal;
+    if (priority != Critical and maxFactor > max) {
+      max = maxFactor < MaxStretch ? maxFactor : MaxStretch;
+    }
+  }
+  void begin()
+  {
+    m_start = micros();
+  }
+  void end()
+  {
+    unsigned long busy = micros() - m_start;
+    /* exponential moving average over roughly eight passes */
+    m_avgUs = busy > m_avgUs ? m_avgUs + (busy - m_avgUs) / 8
+                             : m_avgUs - (m_avgUs - busy) / 8;
+    unsigned long now = millis();
+    if (now - m_lastAdjust < AdjustMs) {
+      return;
+    }
+    m_lastAdjust = now;
+    if (overloaded()) {
+      if (m_low < m_maxLow) {
+        m_low++;
+      } else if (m_normal < m_maxNormal) {
+        m_normal++;
+      }
+    } else if (m_avgUs < m_budgetUs - m_budgetUs / 4) {
+      if (m_normal > 1) {
+        m_normal--;
+      } else if (m_low > 1) {
+        m_low--;
+      }
+    }
+  }
+  /** Factor the periods of the given class are currently stretched by */
+  uint8_t stretch(Priority priority) const
+  {
+    return priority == Low ? m_low : priority == Normal ? m_normal : 1;
+  }
+  bool overloaded() const
+  {
+    return m_avgUs > m_budgetUs;
+  }
+  unsigned long averageUs() const
+  {
+    return m_avgUs;
+  }
+  void setBudgetUs(unsigned long budgetUs)
+  {
+    m_budgetUs = budgetUs;
+  }
+  unsigned long getBudgetUs() const
+  {
+    return m_budgetUs;
+  }
+private:
+  unsigned long m_budgetUs;
+  unsigned long m_avgUs;
+  unsigned long m_start;
+  unsigned long m_lastAdjust;
+  uint8_t m_low;
+  uint8_t m_normal;
+  uint8_t m_maxLow;
+  uint8_t m_maxNormal;
+};
+
+/** PeriodicalBase whose period is stretched by a LoadGovernor under
+ * overload, up to maxFactor times its nominal period, and shrinks back
+ * once the load dropped. Derive from it just as from PeriodicalBase:
+ *
+ * @code{.cpp}
+    class Housekeeping
+      : public ew::AdaptivePeriodicalBase<Housekeeping>
+    {
+    public:
+      Housekeeping()
+        : ew::AdaptivePeriodicalBase<Housekeeping>(governor, 500, Low, 8)
+      {}
+      void task();
+    };
+   @endcode
+ */
+template <class T, class StatsT = ew::NoTaskStats,
+          PeriodicalModes::Phase PhaseV = PeriodicalModes::Restart>
+class AdaptivePeriodicalBase
+  : public PeriodicalBase<T, ew::MillisClock, StatsT, PhaseV>
+  , public LoadPriorities
+{
+  typedef PeriodicalBase<T, ew::MillisClock, StatsT, PhaseV> Base;
+public:
+  AdaptivePeriodicalBase(LoadGovernor &governor,
+                         unsigned long periodMs,
+                         Priority priority = Low,
+                         uint8_t maxFactor = 4)
+    : Base(periodMs)
+    , m_governor(governor)
+    , m_nominalMs(periodMs)
+    , m_priority(priority)
+    , m_maxFactor(maxFactor)
+    , m_factor(1)
+  {
+    governor.registerTask(priority, maxFactor);
+  }
+  /** Adopts the governor's current stretch and runs the task if due */
+  void run()
+  {
+    run(Base::Clock::now());
+  }
+  void run(typename Base::Ticks now)
+  {
+    uint8_t factor = m_governor.stretch(static_cast<Priority>(m_priority));
+    if (factor > m_maxFactor) {
+      factor = m_maxFactor;
+    }
+    if (factor != m_factor) {
+      m_factor = factor;
+      Base::setPeriodMs(m_nominalMs * factor);
+    }
+    Base::run(now);
+  }
+  void setNominalPeriodMs(unsigned long periodMs)
+  {
+    m_nominalMs = periodMs;
+    Base::setPeriodMs(m_nominalMs * m_factor);
+  }
+  unsigned long getNominalPeriodMs() const
+  {
+    return m_nominalMs;
+  }
+  /** Factor the period is currently stretched by */
+  uint8_t factor() const
+  {
+    return m_factor;
+  }
+  Priority getPriority() const
+  {
+    return static_cast<Priority>(m_priority);
+  }
+private:
+  const LoadGovernor &m_governor;
+  unsigned long m_nominalMs;
+  uint8_t m_priority;
+  uint8_t m_maxFactor;
+  uint8_t m_factor;
+};
+
+} // namespace ew
@@ -0,0 +1,182 @@
+/* Non-blocking log output queue drained from the main loop
+ *
+ * EwLogQueue.h
+ *
+ *  Created on: Oct 14, 2026
+ */
+
+#pragma once
+
+#include "EwUtil.h"
+
+namespace ew {
+
+/** Lock-free single-producer/single-consumer byte ring of N bytes which
+ * never blocks the code printing to it.
+ *
+ * Print to it with prtFmt(), operator<< or any Print method from one
+ * context, e.g. the main loop or a single ISR, and drain it from another
+ * one, typically with a LogDrain task. A write that does not fit as a
+ * whole is dropped as a whole, so a line formatted by prtFmt() never shows
+ * up truncated. The dropped bytes are counted.
+ *
+ * N must be a power of two, one byte is kept free to tell a full from an
+ * empty ring. On AVR N is limited to 128 so the indices can be loaded and
+ * stored atomically.
+ *
+ * @code{.cpp}
+    ew::LogQueue<256> logQueue;
+    ew::LogDrain<256> logDrain(logQueue, Serial);
+
+    void control()
+    {
+      prtFmt(logQueue, "pos %ld err %d\r\n", pos, err);
+    }
+    void loop()
+    {
+      control();
+      logDrain.run();
+    }
+   @endcode
+ */
+template <size_t N>
+class LogQueue
+  : public Print
+{
+  static_assert(N >= 2 and (N & (N - 1)) == 0, "LogQueue size must be a power of two");
+#if defined(__AVR__)
+  static_assert(N <= 128, "LogQueue indices must fit into a byte on AVR");
+#endif
+public:
+  typedef typename detail::IndexType<N>::type Index;
+
+  LogQueue()
+    : m_head(0)
+    , m_tail(0)
+    , m_dropped(0)
+  { }
+  LogQueue(const LogQueue &) = delete;
+  LogQueue &operator=(const LogQueue &) = delete;
+
+  size_t write(uint8_t c) override
+  {
+    return write(&c, 1);
+  }
+  size_t write(const uint8_t *buf, size_t len) override
+  {
+    Index head = m_head;
+    Index tail = __atomic_load_n(&m_tail, __ATOMIC_ACQUIRE);
+    if (len > static_cast<Index>(tail - head - 1) % N) {
+      m_dropped += len;
+      return 0;
+    }
+    size_t first = N - head < len ? N - head : len;
+    memcpy(m_buf + head, buf, first);
+    memcpy(m_buf, buf + first, len - first);
+    __atomic_store_n(&m_head, static_cast<Index>((head + len) % N), __ATOMIC_RELEASE);
+    return len;
+  }
+  using Print::write;
+
+  /** Free room for the producer */
+  int availableForWrite()
+  {
+    return static_cast<Index>(__atomic_load_n(&m_tail, __ATOMIC_ACQUIRE) - m_head - 1) % N;
+  }
+  /** Bytes waiting for the consumer */
+  size_t available() const
+  {
+    return static_cast<Index>(__atomic_load_n(&m_head, __ATOMIC_ACQUIRE) - m_tail) % N;
+  }
+  bool empty() const
+  {
+    return not available();
+  }
+  static constexpr size_t capacity()
+  {
+    return N - 1;
+  }
+  /** Bytes dropped because the queue was full. Written by the producer
+   * only, on 8-bit MCUs the value read from another context can be torn.
+   */
+  unsigned long dropped() const
+  {
+    return m_dropped;
+  }
+  /** Consumer side: Writes at most max queued bytes to out and returns the
+   * number of bytes out accepted.
+   */
+  size_t drain(Print &out, size_t max)
+  {
+    size_t done = 0;
+    while (done < max) {
+      Index tail = m_tail;
+      Index head = __atomic_load_n(&m_head, __ATOMIC_ACQUIRE);
+      if (head == tail) {
+        break;
+      }
+      /* the ring is written out in at most two contiguous chunks */
+      size_t len = head > tail ? head - tail : N - tail;
+      if (len > max - done) {
+        len = max - done;
+      }
+      size_t n = out.write(m_buf + tail, len);
+      __atomic_store_n(&m_tail, static_cast<Index>((tail + n) % N), __ATOMIC_RELEASE);
+      done += n;
+      if (n < len) {
+        break;
+      }
+    }
+    return done;
+  }
+  /** Consumer side: Writes as many queued bytes as out can take without
+   * blocking according to its availableForWrite().
+   */
+  size_t drain(Print &out)
+  {
+    int room = out.availableForWrite();
+    return room > 0 ? drain(out, room) : 0;
+  }
+private:
+  uint8_t m_buf[N];
+  Index m_head;
+  Index m_tail;
+  volatile unsigned long m_dropped;
+};
+
+/** Periodic task pushing the contents of a LogQueue to a Print, e.g.
+ * Serial, never writing more than the Print can take without blocking.
+ *
+ * The Print must implement availableForWrite(). Pass maxPerRun to cap
+ * the bytes written per run instead, e.g. for sinks without it.
+ *
+ * As any PeriodicalBase it can be added to an ew::Scheduler.
+ */
+template <size_t N, class ClockT = ew::MillisClock>
+class LogDrain
+  : public PeriodicalBase<LogDrain<N, ClockT>, ClockT>
+{
+public:
+  typedef typename ClockT::Ticks Ticks;
+
+  LogDrain(LogQueue<N> &queue, Print &out, Ticks period = 1, size_t maxPerRun = 0)
+    : PeriodicalBase<LogDrain<N, ClockT>, ClockT>(period)
+    , m_queue(queue)
+    , m_out(out)
+    , m_maxPerRun(maxPerRun)
+  { }
+  void task()
+  {
+    if (m_maxPerRun) {
+      m_queue.drain(m_out, m_maxPerRun);
+    } else {
+      m_queue.drain(m_out);
+    }
+  }
+private:
+  LogQueue<N> &m_queue;
+  Print &m_out;
+  size_t m_maxPerRun;
+};
+
+} // namespace ew
@@ -0,0 +1,425 @@
+/* Attribution of main loop time to tasks
+ *
+ * EwLoopProfiler.h
+ *
+ *  Created on: Oct 14, 2026
+ */
+
+#pragma once
+
+#include "EwUtil.h"
+
+namespace ew {
+
+/** Constant memory histogram of values up to 2^Bits - 1 estimating their
+ * quantiles with a relative error of at most 2^-SubBits.
+ *
+ * The buckets are powers of two split into 2^SubBits sub-buckets each,
+ * larger values are counted in the last bucket. Once a bucket is about to
+ * overflow all counts are halved, so the sketch follows slow changes
+ * instead of being dominated by the past forever.
+ */
+template <uint8_t Bits = 24, uint8_t SubBits = 2>
+class QuantileSketch
+{
+  static_assert(Bits <= 32 and SubBits < Bits, "unsupported QuantileSketch layout");
+public:
+  static const uint16_t NumBuckets = (Bits - SubBits + 1) << SubBits;
+  static const uint32_t MaxValue = uint32_t(0xFFFFFFFF) >> (32 - Bits);
+
+  QuantileSketch()
+  {
+    clear();
+  }
+  void add(uint32_t v)
+  {
+    uint16_t &count = m_counts[bucket(v)];
+    if (count == 0xFFFF) {
+      decay();
+    }
+    count++;
+    m_total++;
+  }
+  void clear()
+  {
+    for (auto &c : m_counts) {
+      c = 0;
+    }
+    m_total = 0;
+  }
+  /** Number of values currently represented */
+  unsigned long count() const
+  {
+    return m_total;
+  }
+  /** Estimated value below which permille/1000 of the values lie, the
+   * upper bound of the bucket containing that rank.
+   */
+  uint32_t quantile(uint16_t permille) const
+  {
+    if (not m_total) {
+      return 0;
+    }
+    unsigned long rank = (static_cast<unsigned long long>(m_total) * permille + 999) / 1000;
+    unsigned long seen = 0;
+    for (uint16_t i = 0; i < NumBuckets; i++) {
+      seen += m_counts[i];
+      if (seen >= rank and seen) {
+        return upper(i);
+      }
+    }
+    return upper(NumBuckets - 1);
+  }
+  static uint16_t bucket(uint32_t v)
+  {
+    if (v > MaxValue) {
+      return NumBuckets - 1;
+    }
+    if (v < (uint32_t(1) << SubBits)) {
+      return v;
+    }
+    uint8_t e = msb(v);
+    return ((e - SubBits + 1) << SubBits) + ((v >> (e - SubBits)) - (uint32_t(1) << SubBits));
+  }
+  /** Largest value counted in bucket i */
+  static uint32_t upper(uint16_t i)
+  {
+    if (i < (1u << SubBits)) {
+      return i;
+    }
+    uint8_t e = (i >> SubBits) + SubBits - 1;
+    uint32_t mantissa = (i & ((1u << SubBits) - 1)) + (uint32_t(1) << SubBits) + 1;
+    return (mantissa << (e - SubBits)) - 1;
+  }
+private:
+  static uint8_t msb(uint32_t v)
+  {
+    uint8_t e = 0;
+    while (v >>= 1) {
+      e++;
+    }
+    return e;
+  }
+  void decay()
+  {
+    m_total = 0;
+    for (auto &c : m_counts) {
+      c >>= 1;
+      m_total += c;
+    }
+  }
+
+  uint16_t m_counts[NumBuckets];
+  unsigned long m_total;
+};
+
+/** Accumulates the time spent in one task for a LoopProfiler. Every slot
+ * registers itself in a global list on construction, the same way as
+ * TaskStats.
+ *
+ * It is a statistics policy for PeriodicalBase, so deriving from
+ * PeriodicalBase<MyTask, ew::MillisClock, ew::ProfileSlot> attributes the
+ * task's run time automatically. For anything else wrap the call in a
+ * Scope:
+ *
+ * @code{.cpp}
+    ew::ProfileSlot mqttSlot("mqtt");
+    ...
+    if (mqttTimer.expired()) {
+      ew::ProfileSlot::Scope scope(mqttSlot);
+      publish();
+    }
+   @endcode
+ */
+class ProfileSlot
+{
+public:
+  class Scope
+  {
+  public:
+    Scope(ProfileSlot &slot)
+      : m_slot(slot)
+      , m_start(micros())
+    {}
+    ~Scope()
+    {
+      m_slot.add(micros() - m_start);
+    }
+  private:
+    ProfileSlot &m_slot;
+    unsigned long m_start;
+  };
+
+  ProfileSlot(const char *name = nullptr)
+    : m_name(name)
+    , m_busyUs(0)
+    , m_next(head())
+  {
+    head() = this;
+  }
+  ~ProfileSlot()
+  {
+    for (ProfileSlot **p = &head(); *p; p = &(*p)->m_next) {
+      if (*p == this) {
+        *p = m_next;
+        break;
+      }
+    }
+  }
+  ProfileSlot(const ProfileSlot &) = delete;
+  ProfileSlot &operator=(const ProfileSlot &) = delete;
+
+  /** Statistics policy interface of PeriodicalBase */
+  template <class ClockT>
+  unsigned long enter(typename ClockT::Ticks /* lateness */)
+  {
+    return micros();
+  }
+  template <class ClockT>
+  void leave(unsigned long start, typename ClockT::Ticks /* period */)
+  {
+    add(micros() - start);
+  }
+
+  void add(unsigned long us)
+  {
+    m_busyUs += us;
+  }
+  /** Busy time since the last report */
+  unsigned long busyUs() const
+  {
+    return m_busyUs;
+  }
+  void clear()
+  {
+    m_busyUs = 0;
+  }
+  void setName(const char *name)
+  {
+    m_name = name;
+  }
+  const char *getName() const
+  {
+    return m_name ? m_name : "<task>";
+  }
+
+  static ProfileSlot *first()
+  {
+    return head();
+  }
+  ProfileSlot *next() const
+  {
+    return m_next;
+  }
+private:
+  static ProfileSlot *&head()
+  {
+    static ProfileSlot *s_head = nullptr;
+    return s_head;
+  }
+
+  const char *m_name;
+  unsigned long m_busyUs;
+  ProfileSlot *m_next;
+};
+
+/** Measures how long loop() takes and which share of it every
+ * ProfileSlot and the idle time took.
+ *
+ * The loop times go into a QuantileSketch for p50/p95/p99, the shares are
+ * computed over a report window. Every reportMs the report is printed as
+ * text or as binary frame to the Print given to setReport(), or it can be
+ * printed with operator<< at any time. Both start a new window.
+ *
+ * @code{.cpp}
+    ew::LoopProfiler profiler;
+
+    void setup()
+    {
+      profiler.setReport(Serial, 10000);
+    }
+    void loop()
+    {
+      profiler.beginLoop();
+      ...
+      {
+        ew::ProfileSlot::Scope idle(profiler.idle());
+        delay(scheduler.run());
+      }
+      profiler.endLoop();
+    }
+   @endcode
+ *
+ * The binary frame is little endian: the magic 'E' 'W' 'P' 1, the window
+ * length, the number of loop passes, p50, p95 and p99 of the loop time in
+ * microseconds as uint32, the number of slots as uint8 and for every slot
+ * its busy time as uint32 and its name as uint8 length and characters.
+ * The idle slot is reported as first slot.
+ */
+class LoopProfiler
+{
+public:
+  typedef enum {
+    Text,
+    Binary,
+  } Format;
+
+  LoopProfiler()
+    : m_idle("idle")
+    , m_report(nullptr)
+    , m_reportMs(0)
+    , m_format(Text)
+    , m_loopStart(0)
+    , m_windowStart(micros())
+    , m_lastReport(millis())
+    , m_loops(0)
+  {}
+  void beginLoop()
+  {
+    m_loopStart = micros();
+  }
+  void endLoop()
+  {
+    m_sketch.add(micros() - m_loopStart);
+    m_loops++;
+    if (m_report and millis() - m_lastReport >= m_reportMs) {
+      if (m_format == Binary) {
+        writeFrame(*m_report);
+      } else {
+        report(*m_report);
+      }
+    }
+  }
+  /** Slot to wrap the time the loop sleeps or waits in */
+  ProfileSlot &idle()
+  {
+    return m_idle;
+  }
+  /** Prints a report every reportMs, see stopReport() */
+  void setReport(Print &prt, unsigned long reportMs, Format format = Text)
+  {
+    m_report = &prt;
+    m_reportMs = reportMs;
+    m_format = format;
+  }
+  void stopReport()
+  {
+    m_report = nullptr;
+  }
+  const QuantileSketch<> &sketch() const
+  {
+    return m_sketch;
+  }
+  uint32_t p50() const { return m_sketch.quantile(500); }
+  uint32_t p95() const { return m_sketch.quantile(950); }
+  uint32_t p99() const { return m_sketch.quantile(990); }
+  /** Loop passes in the current window */
+  unsigned long loops() const
+  {
+    return m_loops;
+  }
+  /** Length of the current window */
+  unsigned long windowUs() const
+  {
+    return micros() - m_windowStart;
+  }
+  /** Share of the current window spent in slot, in permille */
+  unsigned int permille(const ProfileSlot &slot) const
+  {
+    unsigned long window = windowUs();
+    return window ? static_cast<unsigned int>(static_cast<unsigned long long>(slot.busyUs()) * 1000 / window) : 0;
+  }
+  /** Prints the text report and starts a new window */
+  void report(Print &prt)
+  {
+    using namespace ew;
+    prt << "loop n " << m_loops
+        << ", us p50 " << p50() << " p95 " << p95() << " p99 " << p99();
+    printShare(prt, m_idle);
+    for (auto s = ProfileSlot::first(); s; s = s->next()) {
+      if (s != &m_idle) {
+        printShare(prt, *s);
+      }
+    }
+    prt << "\r\n";
+    restart();
+  }
+  /** Writes the binary frame and starts a new window */
+  void writeFrame(Print &prt)
+  {
+    static const uint8_t magic[4] = {'E', 'W', 'P', 1};
+    prt.write(magic, sizeof(magic));
+    putLe32(prt, windowUs());
+    putLe32(prt, m_loops);
+    putLe32(prt, p50());
+    putLe32(prt, p95());
+    putLe32(prt, p99());
+    uint8_t n = 0;
+    for (auto s = ProfileSlot::first(); s and n < 0xFF; s = s->next()) {
+      n++;
+    }
+    prt.write(n);
+    putSlot(prt, m_idle);
+    n--;
+    for (auto s = ProfileSlot::first(); s and n; s = s->next()) {
+      if (s != &m_idle) {
+        putSlot(prt, *s);
+        n--;
+      }
+    }
+    restart();
+  }
+  /** Starts a new window, the loop time quantiles carry on */
+  void restart()
+  {
+    for (auto s = ProfileSlot::first(); s; s = s->next()) {
+      s->clear();
+    }
+    m_windowStart = micros();
+    m_lastReport = millis();
+    m_loops = 0;
+  }
+private:
+  void printShare(Print &prt, const ProfileSlot &slot) const
+  {
+    using namespace ew;
+    unsigned int p = permille(slot);
+    prt << ", " << slot.getName() << ' ' << p / 10 << '.' << p % 10 << '%';
+  }
+  static void putLe32(Print &prt, uint32_t v)
+  {
+    uint8_t b[4] = {uint8_t(v), uint8_t(v >> 8), uint8_t(v >> 16), uint8_t(v >> 24)};
+    prt.write(b, sizeof(b));
+  }
+  static void putSlot(Print &prt, const ProfileSlot &slot)
+  {
+    putLe32(prt, slot.busyUs());
+    const char *name = slot.getName();
+    size_t len = strlen(name);
+    if (len > 0xFF) {
+      len = 0xFF;
+    }
+    prt.write(static_cast<uint8_t>(len));
+    prt.write(reinterpret_cast<const uint8_t *>(name), len);
+  }
+
+  ProfileSlot m_idle;
+  QuantileSketch<> m_sketch;
+  Print *m_report;
+  unsigned long m_reportMs;
+  uint8_t m_format;
+  unsigned long m_loopStart;
+  unsigned long m_windowStart;
+  unsigned long m_lastReport;
+  unsigned long m_loops;
+};
+
+/** Prints the report of the current window and starts a new one */
+inline Print &
+operator <<(Print &prt, LoopProfiler &profiler)
+{
+  profiler.report(prt);
+  return prt;
+}
+
+} // namespace ew
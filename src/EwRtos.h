@@ -0,0 +1,225 @@
+/* Periodic tasks running in their own FreeRTOS tasks on the ESP32
+ *
+ * EwRtos.h
+ *
+ *  Created on: Oct 14, 2026
+ */
+
+#pragma once
+
+#include "EwUtil.h"
+
+#if defined(ESP32)
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+namespace ew {
+
+/** The FreeRTOS tick counter as clock */
+struct RtosClock
+{
+  typedef TickType_t Ticks;
+  static Ticks now()                   { return xTaskGetTickCount(); }
+  static Ticks fromMs(unsigned long ms) { return pdMS_TO_TICKS(ms); }
+  static unsigned long toMs(Ticks t)    { return t * portTICK_PERIOD_MS; }
+  static unsigned long toUs(Ticks t)    { return t * portTICK_PERIOD_MS * 1000UL; }
+};
+
+namespace detail {
+
+/** Next core for RtosAffinity::Auto, shared by all RtosPeriodical types */
+inline uint8_t &
+rtosNextCore()
+{
+  static uint8_t s_next = 0;
+  return s_next;
+}
+
+} // namespace detail
+
+/** Core a RtosPeriodical is pinned to. Auto distributes the tasks round
+ * robin over the cores in the order they are started, AnyCore lets the
+ * FreeRTOS scheduler pick the core on every switch.
+ */
+struct RtosAffinity
+{
+  typedef enum {
+    Core0,
+    Core1,
+    AnyCore,
+    Auto,
+  } Affinity;
+};
+
+/** Counterpart of PeriodicalBase which runs task() in its own FreeRTOS
+ * task instead of the Arduino loop().
+ *
+ * The task sleeps until its next deadline and does not poll, the schedule
+ * follows the Phase semantics of PeriodicalBase. notify() wakes it up to
+ * run once right away in addition to its schedule, e.g. when new data
+ * arrived. Heavy work this way moves off the core running loop():
+ *
+ * @code{.cpp}
+    class Fft
+      : public ew::RtosPeriodical<Fft>
+    {
+    public:
+      Fft()
+        : ew::RtosPeriodical<Fft>(50, Core0, 2)
+      {}
+      void task()
+      {
+        // here comes your code
+      }
+    };
+    Fft fft;
+
+    void setup()
+    {
+      fft.begin("fft");
+    }
+   @endcode
+ *
+ * task() runs concurrently to everything else, protect shared data
+ * accordingly.
+ */
+template <class T>
+class RtosPeriodical
+  : public PeriodicalModes
+  , public RtosAffinity
+{
+public:
+  typedef RtosClock Clock;
+  typedef Clock::Ticks Ticks;
+
+  RtosPeriodical(unsigned long periodMs,
+                 Affinity affinity = Auto,
+                 UBaseType_t priority = 1,
+                 uint32_t stackSize = 4096,
+                 Phase phase = Skip)
+    : m_handle(nullptr)
+    , m_period(toPeriod(periodMs))
+    , m_prev(0)
+    , m_missed(0)
+    , m_phase(phase)
+    , m_affinity(affinity)
+    , m_priority(priority)
+    , m_stackSize(stackSize)
+  {}
+  ~RtosPeriodical()
+  {
+    end();
+  }
+  RtosPeriodical(const RtosPeriodical &) = delete;
+  RtosPeriodical &operator=(const RtosPeriodical &) = delete;
+
+  /** Creates the FreeRTOS task, returns false if that failed */
+  bool begin(const char *name = "ew")
+  {
+    if (m_handle) {
+      return true;
+    }
+    BaseType_t core = tskNO_AFFINITY;
+    if (m_affinity == Auto) {
+      core = detail::rtosNextCore()++ % portNUM_PROCESSORS;
+    } else if (m_affinity != AnyCore) {
+      core = m_affinity % portNUM_PROCESSORS;
+    }
+    return xTaskCreatePinnedToCore(&entry, name, m_stackSize, this,
+                                   m_priority, &m_handle, core) == pdPASS;
+  }
+  /** Deletes the FreeRTOS task. Do not call it from task() itself. */
+  void end()
+  {
+    if (m_handle) {
+      vTaskDelete(m_handle);
+      m_handle = nullptr;
+    }
+  }
+  bool running() const
+  {
+    return m_handle != nullptr;
+  }
+  /** Runs the task once as soon as possible */
+  void notify()
+  {
+    if (m_handle) {
+      xTaskNotifyGive(m_handle);
+    }
+  }
+  void notifyFromIsr()
+  {
+    if (m_handle) {
+      BaseType_t woken = pdFALSE;
+      vTaskNotifyGiveFromISR(m_handle, &woken);
+      if (woken) {
+        portYIELD_FROM_ISR();
+      }
+    }
+  }
+  /** Takes effect after the next run, periods shorter than one tick are
+   * rounded up to it
+   */
+  void setPeriodMs(unsigned long periodMs)
+  {
+    m_period = toPeriod(periodMs);
+  }
+  unsigned long getPeriodMs() const
+  {
+    return Clock::toMs(m_period);
+  }
+  Phase getPhase() const
+  {
+    return static_cast<Phase>(m_phase);
+  }
+  /** See PeriodicalBase::missed() */
+  Ticks missed() const
+  {
+    return m_missed;
+  }
+  TaskHandle_t handle() const
+  {
+    return m_handle;
+  }
+private:
+  /** At least one tick, pdMS_TO_TICKS() rounds shorter periods down to
+   * zero and the task would spin without ever blocking
+   */
+  static Ticks toPeriod(unsigned long periodMs)
+  {
+    Ticks period = Clock::fromMs(periodMs);
+    return period ? period : 1;
+  }
+  static void entry(void *self)
+  {
+    static_cast<RtosPeriodical *>(self)->loop();
+  }
+  void loop()
+  {
+    m_prev = Clock::now();
+    for (;;) {
+      Ticks wait = PeriodicalModes::remaining<Ticks>(Clock::now() - m_prev, m_period, m_phase);
+      if (wait and ulTaskNotifyTake(pdTRUE, wait)) {
+        static_cast<T*>(this)->task();
+        continue;
+      }
+      if (due<Ticks>(Clock::now(), m_prev, m_period, m_phase, m_missed)) {
+        static_cast<T*>(this)->task();
+      }
+    }
+  }
+
+  TaskHandle_t m_handle;
+  volatile Ticks m_period;
+  Ticks m_prev;
+  Ticks m_missed;
+  uint8_t m_phase;
+  uint8_t m_affinity;
+  UBaseType_t m_priority;
+  uint32_t m_stackSize;
+};
+
+} // namespace ew
+
+#endif // ESP32
@@ -0,0 +1,324 @@
+/* Cooperative scheduler for Periodicals and Timers
+ *
+ * EwScheduler.h
+ *
+ *  Created on: Oct 14, 2026
+ */
+
+#pragma once
+
+#include "EwUtil.h"
+
+namespace ew {
+
+/** Owns a fixed number of registered tasks, keeps track of the earliest
+ * deadline and only walks the tasks when that deadline has passed. All
+ * other loop passes cost a single clock read and comparison.
+ *
+ * Anything providing run() and remaining() can be registered, which
+ * includes Periodical and everything derived from PeriodicalBase. Timers
+ * are registered together with a callback which is called on expiry.
+ * Tasks derived from SlicedPeriodicalBase are only started when due, their
+ * slices run in the gaps between the deadlines of all other tasks, each
+ * of them limited to the gap.
+ *
+ * The scheduler only learns about a new deadline when it walks its tasks.
+ * If you start or stop a registered Timer or change a period from outside
+ * of a scheduled callback, call reschedule() afterwards.
+ *
+ * All tasks have to run on the scheduler's clock. A walk samples it once
+ * and passes that now to the run(now), expired(now) and remaining(now)
+ * of the tasks providing them, see Tick.
+ *
+ * @code{.cpp}
+    ew::Scheduler<8> scheduler([](unsigned long ms) { delay(ms); });
+
+    void setup()
+    {
+      scheduler.add(myPeriodical);
+      scheduler.add(myTimer, onTimeout);
+    }
+    void loop()
+    {
+      scheduler.run();
+    }
+   @endcode
+ */
+template <size_t MaxTasks = 8, class ClockT = MillisClock>
+class Scheduler
+{
+public:
+  typedef ClockT Clock;
+  typedef typename Clock::Ticks Ticks;
+  typedef TickTraits<Ticks> Traits;
+  typedef BasicTimer<Clock> TimerType;
+
+  /** Called with the number of ticks (milliseconds unless running on
+   * another clock) until the next deadline. Use it to delay(), enter
+   * light sleep or wait for an interrupt.
+   */
+  typedef void (*IdleHook)(Ticks ticks);
+  typedef void (*Callback)(void *ctx);
+
+  Scheduler(IdleHook idleHook = nullptr)
+    : m_numTasks(0)
+    , m_valid(false)
+    , m_hasDue(false)
+    , m_slicing(false)
+    , m_nextSlice(0)
+    , m_due(0)
+    , m_idleHook(idleHook)
+  {}
+  template <class T>
+  bool add(T &task)
+  {
+    static_assert(detail::IsSame<typename T::Clock, Clock>::value,
+                  "task and scheduler must run on the same clock");
+    return add(&task, Sliced<T>::run(), &remainingTask<T>, nullptr, nullptr,
+               Sliced<T>::pending(), Sliced<T>::slice());
+  }
+  /** Registers anything providing expired() and remaining(), e.g. a
+   * Timer or an AtomicTimer, calling callback on expiry.
+   */
+  template <class TimerT>
+  bool add(TimerT &timer, Callback callback, void *ctx = nullptr)
+  {
+    static_assert(detail::IsSame<typename TimerT::Clock, Clock>::value,
+                  "timer and scheduler must run on the same clock");
+    return add(&timer, &runTimer<TimerT>, &remainingTimer<TimerT>, callback, ctx,
+               nullptr, nullptr);
+  }
+  void remove(const void *task)
+  {
+    for (size_t i = 0; i < m_numTasks; i++) {
+      if (m_tasks[i].obj == task) {
+        m_tasks[i] = m_tasks[--m_numTasks];
+        break;
+      }
+    }
+    reschedule();
+  }
+  /** Forces the tasks to be walked on the next call to run(). */
+  void reschedule()
+  {
+    m_valid = false;
+  }
+  /** Ticks until the next deadline, Traits::Never if there is none and
+   * zero while sliced tasks have work pending. Runs all due tasks if the
+   * earliest deadline has passed, otherwise one slice of a pending sliced
+   * task, and calls the idle hook with the time left until the next one.
+   */
+  Ticks run()
+  {
+    Ticks left = poll();
+    if (m_idleHook and left and left != Traits::Never) {
+      m_idleHook(left);
+    }
+    return left;
+  }
+  /** Same as run() but without calling the idle hook. */
+  Ticks poll()
+  {
+    Ticks now = Clock::now();
+    Ticks next;
+    if (m_valid and (not m_hasDue or Traits::before(now, m_due))) {
+      next = m_hasDue ? m_due - now : Traits::Never;
+    } else {
+      next = walk(now);
+      if (m_hasDue) {
+        /* the tasks took their time, what is left is measured after them */
+        Ticks end = Clock::now();
+        next = Traits::before(end, m_due) ? m_due - end : 0;
+      }
+    }
+    if (m_slicing) {
+      slice(next);
+      return 0;
+    }
+    return next;
+  }
+  size_t size() const
+  {
+    return m_numTasks;
+  }
+private:
+  struct Task
+  {
+    void *obj;
+    void (*run)(Task &, Ticks now);
+    Ticks (*remaining)(const Task &, Ticks now);
+    Callback callback;
+    void *ctx;
+    bool (*pending)(const Task &);
+    bool (*slice)(Task &, unsigned long budgetUs);
+  };
+  typedef void (*RunThunk)(Task &, Ticks);
+  typedef bool (*PendingThunk)(const Task &);
+  typedef bool (*SliceThunk)(Task &, unsigned long);
+
+  /** Slice thunks for tasks tagged with SliceTag, see EwSliced.h */
+  template <class T, class = void>
+  struct Sliced
+  {
+    static RunThunk run()         { return &runTask<T>; }
+    static PendingThunk pending() { return nullptr; }
+    static SliceThunk slice()     { return nullptr; }
+  };
+  template <class T>
+  struct Sliced<T, typename T::SliceTag>
+  {
+    /* only starts the job, its slices run in the gaps */
+    static RunThunk run()         { return &pollTask<T>; }
+    static PendingThunk pending() { return &pendingTask<T>; }
+    static SliceThunk slice()     { return &sliceTask<T>; }
+  };
+
+  bool add(void *obj,
+           RunThunk run,
+           Ticks (*remaining)(const Task &, Ticks),
+           Callback callback,
+           void *ctx,
+           PendingThunk pending,
+           SliceThunk slice)
+  {
+    if (m_numTasks >= MaxTasks) {
+      return false;
+    }
+    m_tasks[m_numTasks++] = Task{obj, run, remaining, callback, ctx, pending, slice};
+    reschedule();
+    return true;
+  }
+  /** Runs all tasks and returns the ticks until the earliest deadline,
+   * all of them at the same now
+   */
+  Ticks walk(Ticks now)
+  {
+    m_slicing = false;
+    for (size_t i = 0; i < m_numTasks; i++) {
+      m_tasks[i].run(m_tasks[i], now);
+      if (m_tasks[i].pending and m_tasks[i].pending(m_tasks[i])) {
+        m_slicing = true;
+      }
+    }
+    Ticks next = Traits::Never;
+    for (size_t i = 0; i < m_numTasks; i++) {
+      auto left = m_tasks[i].remaining(m_tasks[i], now);
+      if (left < next) {
+        next = left;
+      }
+    }
+    m_valid = true;
+    m_hasDue = next != Traits::Never;
+    if (not m_hasDue) {
+      return Traits::Never;
+    }
+    /* keep the deadline within the range of rollover-safe comparison */
+    if (next > Traits::MaxDelta) {
+      next = Traits::MaxDelta;
+    }
+    m_due = now + next;
+    return next;
+  }
+  /** Runs one slice of the next pending sliced task, round robin, within
+   * the gap until the next deadline.
+   */
+  void slice(Ticks next)
+  {
+    for (size_t k = 0; k < m_numTasks; k++) {
+      size_t i = (m_nextSlice + k) % m_numTasks;
+      Task &task = m_tasks[i];
+      if (task.pending and task.pending(task)) {
+        m_nextSlice = i + 1;
+        unsigned long gap = next == Traits::Never ? ULONG_MAX : Clock::toUs(next);
+        if (not task.slice(task, gap)) {
+          /* the task has a new deadline now */
+          reschedule();
+        }
+        return;
+      }
+    }
+    m_slicing = false;
+  }
+  /* run(now), remaining(now) and expired(now) where a task has them, see
+   * Tick, otherwise the variants reading the clock themselves
+   */
+  template <class T>
+  static auto runAt(T &task, Ticks now, int) -> decltype(task.run(now), void())
+  {
+    task.run(now);
+  }
+  template <class T>
+  static void runAt(T &task, Ticks, long)
+  {
+    task.run();
+  }
+  template <class T>
+  static auto remainingAt(const T &task, Ticks now, int) -> decltype(Ticks(task.remaining(now)))
+  {
+    return task.remaining(now);
+  }
+  template <class T>
+  static Ticks remainingAt(const T &task, Ticks, long)
+  {
+    return task.remaining();
+  }
+  template <class T>
+  static auto expiredAt(T &timer, Ticks now, int) -> decltype(bool(timer.expired(now)))
+  {
+    return timer.expired(now);
+  }
+  template <class T>
+  static bool expiredAt(T &timer, Ticks, long)
+  {
+    return timer.expired();
+  }
+
+  template <class T>
+  static void runTask(Task &task, Ticks now)
+  {
+    runAt(*static_cast<T *>(task.obj), now, 0);
+  }
+  template <class T>
+  static Ticks remainingTask(const Task &task, Ticks now)
+  {
+    return remainingAt(*static_cast<const T *>(task.obj), now, 0);
+  }
+  template <class T>
+  static void pollTask(Task &task, Ticks)
+  {
+    static_cast<T *>(task.obj)->poll();
+  }
+  template <class T>
+  static bool pendingTask(const Task &task)
+  {
+    return static_cast<const T *>(task.obj)->pending();
+  }
+  template <class T>
+  static bool sliceTask(Task &task, unsigned long budgetUs)
+  {
+    return static_cast<T *>(task.obj)->runSlice(budgetUs);
+  }
+  template <class TimerT>
+  static void runTimer(Task &task, Ticks now)
+  {
+    if (expiredAt(*static_cast<TimerT *>(task.obj), now, 0) and task.callback) {
+      task.callback(task.ctx);
+    }
+  }
+  template <class TimerT>
+  static Ticks remainingTimer(const Task &task, Ticks now)
+  {
+    return remainingAt(*static_cast<const TimerT *>(task.obj), now, 0);
+  }
+
+  Task m_tasks[MaxTasks];
+  size_t m_numTasks;
+  bool m_valid;
+  bool m_hasDue;
+  bool m_slicing;
+  size_t m_nextSlice;
+  Ticks m_due;
+  IdleHook m_idleHook;
+};
+
+} // namespace ew
@@ -0,0 +1,193 @@
+/* Periodic tasks split into time-budgeted slices
+ *
+ * EwSliced.h
+ *
+ *  Created on: Oct 14, 2026
+ */
+
+#pragma once
+
+#include "EwUtil.h"
+
+/** Protothread-style macros for the task() of a SlicedPeriodicalBase.
+ * Put EW_SLICE_BEGIN() first and EW_SLICE_END() last, in between
+ * EW_SLICE_YIELD() returns and resumes right after it in the next slice,
+ * EW_SLICE_CHECK() only does so once the slice ran out of its budget.
+ *
+ * As the task's stack frame is gone between slices, everything which has
+ * to survive a yield must be a member. Use at most one macro per line and
+ * none within a switch statement of your own.
+ */
+#define EW_SLICE_BEGIN() switch (this->m_resume) { case 0:
+#define EW_SLICE_YIELD() \
+  do { this->m_resume = __LINE__; return ew::Slice::Pending; case __LINE__:; } while (0)
+#define EW_SLICE_CHECK() \
+  do { if (this->overBudget()) { EW_SLICE_YIELD(); } } while (0)
+#define EW_SLICE_END() } return ew::Slice::Done
+
+namespace ew {
+
+/** Result of a slice */
+struct Slice
+{
+  typedef enum {
+    Done,
+    Pending,
+  } Result;
+};
+
+/** Counterpart of PeriodicalBase for long running tasks.
+ *
+ * When due, the task's job is started and task() is called repeatedly,
+ * once per run() or once per gap the Scheduler finds between other
+ * deadlines, until it returns Done. Each slice has a budget of budgetUs
+ * microseconds, or less if the Scheduler's next deadline is closer. The
+ * task checks it with EW_SLICE_CHECK() (or overBudget()) and returns
+ * Pending to resume from there in the next slice:
+ *
+ * @code{.cpp}
+    class Compactor
+      : public ew::SlicedPeriodicalBase<Compactor>
+    {
+    public:
+      Compactor()
+        : ew::SlicedPeriodicalBase<Compactor>(60000, 2000)
+      {}
+      Result task()
+      {
+        EW_SLICE_BEGIN();
+        for (m_page = 0; m_page < NumPages; m_page++) {
+          compactPage(m_page);
+          EW_SLICE_CHECK();
+        }
+        EW_SLICE_END();
+      }
+    private:
+      uint16_t m_page;
+    };
+   @endcode
+ *
+ * A job which takes longer than the period delays the next one, jobs
+ * never overlap.
+ */
+template <class T, class ClockT = ew::MillisClock>
+class SlicedPeriodicalBase
+  : public PeriodicalModes
+  , public Slice
+{
+public:
+  typedef ClockT Clock;
+  typedef typename Clock::Ticks Ticks;
+  /** Tells the Scheduler to run the slices in the gaps between deadlines */
+  typedef void SliceTag;
+
+  SlicedPeriodicalBase(Ticks period, unsigned long budgetUs, Phase phase = Restart)
+    : m_resume(0)
+    , m_period(period)
+    , m_prev(0)
+    , m_missed(0)
+    , m_budgetUs(budgetUs)
+    , m_sliceStart(0)
+    , m_sliceBudget(0)
+    , m_phase(phase)
+    , m_pending(false)
+  {}
+  /** Starts the job if due and runs one slice of it if pending. Call it
+   * from the main loop or add the task to an ew::Scheduler instead.
+   */
+  void run()
+  {
+    if (poll()) {
+      runSlice(m_budgetUs);
+    }
+  }
+  /** Starts the job if due, returns true if it is pending */
+  bool poll()
+  {
+    if (not m_pending and due(Clock::now(), m_prev, m_period, m_phase, m_missed)) {
+      m_pending = true;
+      m_resume = 0;
+    }
+    return m_pending;
+  }
+  /** Runs one slice of at most budgetUs or the task's own budget, returns
+   * true if the job is still pending afterwards.
+   */
+  bool runSlice(unsigned long budgetUs)
+  {
+    if (not m_pending) {
+      return false;
+    }
+    m_sliceStart = micros();
+    m_sliceBudget = budgetUs < m_budgetUs ? budgetUs : m_budgetUs;
+    if (static_cast<T*>(this)->task() == Done) {
+      m_pending = false;
+      m_resume = 0;
+    }
+    return m_pending;
+  }
+  bool pending() const
+  {
+    return m_pending;
+  }
+  /** true once the current slice used up its budget */
+  bool overBudget() const
+  {
+    return micros() - m_sliceStart >= m_sliceBudget;
+  }
+  /** Ticks until the next job is due, Never while one is pending */
+  Ticks remaining() const
+  {
+    if (m_pending) {
+      return TickTraits<Ticks>::Never;
+    }
+    return PeriodicalModes::remaining<Ticks>(Clock::now() - m_prev, m_period, m_phase);
+  }
+  /** Cancels the pending job */
+  void cancel()
+  {
+    m_pending = false;
+    m_resume = 0;
+  }
+  void setPeriod(Ticks period)
+  {
+    m_period = period;
+  }
+  Ticks getPeriod() const
+  {
+    return m_period;
+  }
+  void setBudgetUs(unsigned long budgetUs)
+  {
+    m_budgetUs = budgetUs;
+  }
+  unsigned long getBudgetUs() const
+  {
+    return m_budgetUs;
+  }
+  /** See PeriodicalBase::missed() */
+  Ticks missed() const
+  {
+    return m_missed;
+  }
+  /** Re-anchors the schedule to the current time */
+  void reset()
+  {
+    m_prev = Clock::now();
+    m_missed = 0;
+  }
+protected:
+  /** Resume point of the EW_SLICE macros */
+  uint16_t m_resume;
+private:
+  Ticks m_period;
+  Ticks m_prev;
+  Ticks m_missed;
+  unsigned long m_budgetUs;
+  unsigned long m_sliceStart;
+  unsigned long m_sliceBudget;
+  uint8_t m_phase;
+  bool m_pending;
+};
+
+} // namespace ew
@@ -0,0 +1,315 @@
+/* Streaming printf-style formatting straight into a Print
+ *
+ * EwStreamFmt.h
+ *
+ *  Created on: Oct 14, 2026
+ */
+
+#pragma once
+
+#include "EwUtil.h"
+
+#include <math.h>
+
+namespace ew {
+
+namespace detail {
+
+inline void
+padStream(Print &prt, char c, size_t n)
+{
+  char pad[8];
+  memset(pad, c, sizeof(pad));
+  while (n) {
+    size_t chunk = n < sizeof(pad) ? n : sizeof(pad);
+    prt.write(reinterpret_cast<const uint8_t*>(pad), chunk);
+    n -= chunk;
+  }
+}
+
+/** Widths and precisions of vstreamFmt() are limited to four digits */
+static const int StreamFmtMaxWidth = 9999;
+
+/** Parses a width or precision, saturating at StreamFmtMaxWidth */
+inline int
+parseWidth(const char *&fmt)
+{
+  int v = 0;
+  for (; *fmt >= '0' and *fmt <= '9'; fmt++) {
+    v = v * 10 + (*fmt - '0');
+    if (v > StreamFmtMaxWidth) {
+      v = StreamFmtMaxWidth;
+    }
+  }
+  return v;
+}
+
+inline int
+clampWidth(int v)
+{
+  return v > StreamFmtMaxWidth ? StreamFmtMaxWidth : v;
+}
+
+/** Writes v of at most four digits */
+inline char *
+putDecimal(char *p, unsigned int v)
+{
+  char tmp[4];
+  char *t = tmp;
+  do {
+    *t++ = '0' + v % 10;
+    v /= 10;
+  } while (v);
+  while (t != tmp) {
+    *p++ = *--t;
+  }
+  return p;
+}
+
+} // namespace detail
+
+/** printf-style formatting which writes straight to prt.
+ *
+ * Literal text is written directly from the format string, %s arguments
+ * directly from the argument and only single numeric conversions go
+ * through a small window of Window bytes on the stack. Unlike prtFmt()
+ * the output length is therefore not limited by a buffer.
+ *
+ * Supports the flags, width, precision (including *) and length
+ * modifiers of printf. Widths and precisions saturate at 9999, integer
+ * precisions beyond the window are zero-filled outside of it. %n is not
+ * supported and ignored, %lc and %ls are not supported and printed
+ * verbatim. A floating point conversion not fitting the
+ * window falls back to Print::print(double, digits).
+ */
+template <size_t Window = 24>
+inline Print &
+vstreamFmt(Print &prt, const char *fmt, va_list args)
+{
+  static_assert(Window >= 24, "window too small for a 64-bit octal number");
+
+  char win[Window];
+  const char *lit = fmt;
+  while (*fmt) {
+    if (*fmt != '%') {
+      fmt++;
+      continue;
+    }
+    if (fmt != lit) {
+      prt.write(reinterpret_cast<const uint8_t*>(lit), fmt - lit);
+    }
+    const char *start = fmt++;
+    if (*fmt == '%') {
+      /* emitted with the next literal */
+      lit = fmt++;
+      continue;
+    }
+
+    /* the conversion is rebuilt with * resolved and without the width:
+     * '%', up to five flags, '.', four digits, two length characters, the
+     * conversion and the terminator
+     */
+    char spec[16];
+    char *sp = spec;
+    *sp++ = '%';
+    bool left = false, zero = false;
+    for (; *fmt and strchr("-+ #0", *fmt); fmt++) {
+      left |= *fmt == '-';
+      zero |= *fmt == '0';
+      if (sp < spec + 6) {
+        *sp++ = *fmt;
+      }
+    }
+    int width = 0;
+    if (*fmt == '*') {
+      width = va_arg(args, int);
+      if (width < 0) {
+        left = true;
+        width = width < -detail::StreamFmtMaxWidth ? detail::StreamFmtMaxWidth : -width;
+      }
+      width = detail::clampWidth(width);
+      fmt++;
+    } else {
+      width = detail::parseWidth(fmt);
+    }
+    int prec = -1;
+    if (*fmt == '.') {
+      fmt++;
+      if (*fmt == '*') {
+        prec = va_arg(args, int);
+        if (prec >= 0) {
+          prec = detail::clampWidth(prec);
+        }
+        fmt++;
+      } else {
+        prec = detail::parseWidth(fmt);
+      }
+    }
+    const char *len = fmt;
+    for (; *fmt and strchr("hlLzjt", *fmt); fmt++) {}
+    char conv = *fmt;
+    if (not conv) {
+      lit = fmt;
+      break;
+    }
+    fmt++;
+    lit = fmt;
+    /* integer digits beyond the window are zero-filled by hand below */
+    bool integer = strchr("diuoxX", conv) != nullptr;
+    int specPrec = integer and prec > int(Window) - 4 ? int(Window) - 4 : prec;
+    if (specPrec >= 0) {
+      *sp++ = '.';
+      sp = detail::putDecimal(sp, specPrec);
+    }
+    /* floating point values are passed on as double, without the L */
+    for (const char *c = len; c != fmt - 1 and c - len < 2 and not strchr("fFeEgGaA", conv); c++) {
+      *sp++ = *c;
+    }
+    *sp++ = conv;
+    *sp = '\0';
+
+    bool l = len[0] == 'l', ll = l and len[1] == 'l';
+    if (l and (conv == 'c' or conv == 's')) {
+      /* wide characters are not supported, skip the argument */
+      if (conv == 'c') {
+        va_arg(args, __WINT_TYPE__);
+      } else {
+        va_arg(args, const wchar_t*);
+      }
+      prt.write(reinterpret_cast<const uint8_t*>(start), fmt - start);
+      continue;
+    }
+    int n = -1;
+    switch (conv) {
+      case 's': {
+        const char *str = va_arg(args, const char*);
+        if (not str) {
+          str = "(null)";
+        }
+        size_t slen = 0;
+        while (str[slen] and (prec < 0 or slen < size_t(prec))) {
+          slen++;
+        }
+        size_t pad = size_t(width) > slen ? width - slen : 0;
+        if (not left) {
+          detail::padStream(prt, ' ', pad);
+        }
+        prt.write(reinterpret_cast<const uint8_t*>(str), slen);
+        if (left) {
+          detail::padStream(prt, ' ', pad);
+        }
+        continue;
+      }
+      case 'd': case 'i':
+        if (ll) {
+          n = snprintf(win, Window, spec, va_arg(args, long long));
+        } else if (l) {
+          n = snprintf(win, Window, spec, va_arg(args, long));
+        } else if (*len == 'z' or *len == 't') {
+          n = snprintf(win, Window, spec, va_arg(args, ptrdiff_t));
+        } else if (*len == 'j') {
+          n = snprintf(win, Window, spec, va_arg(args, intmax_t));
+        } else {
+          n = snprintf(win, Window, spec, va_arg(args, int));
+        }
+        break;
+      case 'u': case 'o': case 'x': case 'X':
+        if (ll) {
+          n = snprintf(win, Window, spec, va_arg(args, unsigned long long));
+        } else if (l) {
+          n = snprintf(win, Window, spec, va_arg(args, unsigned long));
+        } else if (*len == 'z' or *len == 't') {
+          n = snprintf(win, Window, spec, va_arg(args, size_t));
+        } else if (*len == 'j') {
+          n = snprintf(win, Window, spec, va_arg(args, uintmax_t));
+        } else {
+          n = snprintf(win, Window, spec, va_arg(args, unsigned int));
+        }
+        break;
+      case 'c':
+        n = snprintf(win, Window, spec, va_arg(args, int));
+        break;
+      case 'p':
+        n = snprintf(win, Window, spec, va_arg(args, void*));
+        break;
+      case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': case 'a': case 'A': {
+        double v = *len == 'L' ? static_cast<double>(va_arg(args, long double))
+                               : va_arg(args, double);
+        n = snprintf(win, Window, spec, v);
+        if (n < 0 or size_t(n) >= Window) {
+          prt.print(v, prec < 0 ? 6 : prec);
+          continue;
+        }
+        /* the precision does not disable zero padding here, but like
+         * printf inf and nan are padded with spaces
+         */
+        prec = -1;
+        zero = zero and not isinf(v) and not isnan(v);
+        break;
+      }
+      case '%':
+        n = 1;
+        win[0] = '%';
+        break;
+      case 'n':
+        va_arg(args, int*);
+        continue;
+      default:
+        /* unknown conversion, print it verbatim */
+        prt.write(reinterpret_cast<const uint8_t*>(start), fmt - start);
+        continue;
+    }
+    if (n < 0) {
+      continue;
+    }
+    if (size_t(n) >= Window) {
+      n = Window - 1;
+    }
+    /* sign or 0x, zeros go between it and the digits */
+    size_t prefix = 0;
+    if (conv != 'c' and conv != 'p' and conv != '%') {
+      prefix = (win[0] == '-' or win[0] == '+' or win[0] == ' ') ? 1 : 0;
+      if (n > int(prefix) + 1 and win[prefix] == '0' and (win[prefix + 1] == 'x' or win[prefix + 1] == 'X')) {
+        prefix += 2;
+      }
+    }
+    size_t fill = integer and prec > n - int(prefix) ? prec - (n - prefix) : 0;
+    size_t total = n + fill;
+    size_t pad = size_t(width) > total ? width - total : 0;
+    if (pad and not left and zero and prec < 0 and conv != 'c' and conv != 'p') {
+      fill += pad;
+      pad = 0;
+    }
+    if (not left) {
+      detail::padStream(prt, ' ', pad);
+    }
+    prt.write(reinterpret_cast<const uint8_t*>(win), prefix);
+    detail::padStream(prt, '0', fill);
+    prt.write(reinterpret_cast<const uint8_t*>(win + prefix), n - prefix);
+    if (left) {
+      detail::padStream(prt, ' ', pad);
+    }
+  }
+  if (fmt != lit) {
+    prt.write(reinterpret_cast<const uint8_t*>(lit), fmt - lit);
+  }
+  return prt;
+}
+
+template <size_t Window = 24>
+Print &
+streamFmt(Print &prt, const char *fmt, ...)
+  __attribute__ ((format (printf, 2, 3)));
+
+template <size_t Window>
+inline Print &
+streamFmt(Print &prt, const char *fmt, ...)
+{
+  va_list args;
+  va_start(args, fmt);
+  vstreamFmt<Window>(prt, fmt, args);
+  va_end(args);
+  return prt;
+}
+
+} // namespace ew
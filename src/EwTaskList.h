@@ -0,0 +1,399 @@
+/* Intrusive task registry and object pool
+ *
+ * EwTaskList.h
+ *
+ *  Created on: Oct 14, 2026
+ */
+
+#pragma once
+
+#include "EwUtil.h"
+
+namespace ew {
+
+/** Node of an IntrusiveList embedded into the listed object by deriving
+ * from it. Linking and unlinking are O(1) and never allocate, an object
+ * unlinks itself when it is destroyed. Copies start out unlinked.
+ */
+class ListHook
+{
+public:
+  ListHook()
+    : m_prev(this)
+    , m_next(this)
+  {}
+  ListHook(const ListHook &)
+    : m_prev(this)
+    , m_next(this)
+  {}
+  ListHook &operator=(const ListHook &)
+  {
+    return *this;
+  }
+  ~ListHook()
+  {
+    unlink();
+  }
+  bool linked() const
+  {
+    return m_next != this;
+  }
+  /** Removes the object from whatever list it is in */
+  void unlink()
+  {
+    m_prev->m_next = m_next;
+    m_next->m_prev = m_prev;
+    m_prev = m_next = this;
+  }
+private:
+  template <class T> friend class IntrusiveList;
+
+  void linkBefore(ListHook &pos)
+  {
+    unlink();
+    m_prev = pos.m_prev;
+    m_next = &pos;
+    pos.m_prev->m_next = this;
+    pos.m_prev = this;
+  }
+
+  ListHook *m_prev;
+  ListHook *m_next;
+};
+
+/** Doubly-linked list of objects deriving from ListHook, which don't
+ * belong to the list: it neither allocates nor destroys them. An object is
+ * in one list at a time, pushing it moves it.
+ *
+ * Iterating stays valid if the current object unlinks itself, as long as
+ * the iterator was advanced before.
+ */
+template <class T>
+class IntrusiveList
+{
+public:
+  template <class U, class HookT>
+  class BasicIterator
+  {
+  public:
+    explicit BasicIterator(HookT *hook)
+      : m_hook(hook)
+    {}
+    U &operator*() const
+    {
+      return static_cast<U &>(*m_hook);
+    }
+    U *operator->() const
+    {
+      return static_cast<U *>(m_hook);
+    }
+    BasicIterator &operator++()
+    {
+      m_hook = m_hook->m_next;
+      return *this;
+    }
+    BasicIterator operator++(int)
+    {
+      BasicIterator it = *this;
+      m_hook = m_hook->m_next;
+      return it;
+    }
+    bool operator==(const BasicIterator &other) const
+    {
+      return m_hook == other.m_hook;
+    }
+    bool operator!=(const BasicIterator &other) const
+    {
+      return m_hook != other.m_hook;
+    }
+  private:
+    HookT *m_hook;
+  };
+  typedef BasicIterator<T, ListHook> Iterator;
+  typedef BasicIterator<const T, const ListHook> ConstIterator;
+
+  IntrusiveList() {}
+  IntrusiveList(const IntrusiveList &) = delete;
+  IntrusiveList &operator=(const IntrusiveList &) = delete;
+  ~IntrusiveList()
+  {
+    clear();
+  }
+  void pushBack(T &obj)
+  {
+    obj.linkBefore(m_head);
+  }
+  void pushFront(T &obj)
+  {
+    obj.linkBefore(*m_head.m_next);
+  }
+  /** obj has to be in this list */
+  void remove(T &obj)
+  {
+    obj.unlink();
+  }
+  /** Unlinks all objects */
+  void clear()
+  {
+    while (m_head.linked()) {
+      m_head.m_next->unlink();
+    }
+  }
+  bool empty() const
+  {
+    return not m_head.linked();
+  }
+  /** Number of objects, walks the list */
+  size_t size() const
+  {
+    size_t n = 0;
+    for (const ListHook *h = m_head.m_next; h != &m_head; h = h->m_next) {
+      n++;
+    }
+    return n;
+  }
+  T &front()
+  {
+    return static_cast<T &>(*m_head.m_next);
+  }
+  Iterator begin()
+  {
+    return Iterator(m_head.m_next);
+  }
+  Iterator end()
+  {
+    return Iterator(&m_head);
+  }
+  ConstIterator begin() const
+  {
+    return ConstIterator(m_head.m_next);
+  }
+  ConstIterator end() const
+  {
+    return ConstIterator(&m_head);
+  }
+private:
+  ListHook m_head;
+};
+
+/** Storage for up to N objects of type T without touching the heap, e.g.
+ * for objects created and destroyed per connection. create() and
+ * destroy() are O(1), the free slots are kept in a list threaded through
+ * the slots themselves.
+ *
+ * Objects still alive when the pool goes are not destroyed, pools are
+ * meant to be globals.
+ */
+template <class T, size_t N>
+class ObjectPool
+{
+public:
+  ObjectPool()
+    : m_free(nullptr)
+    , m_used(0)
+  {
+    for (size_t i = N; i--; ) {
+      m_slots[i].next = m_free;
+      m_free = &m_slots[i];
+    }
+  }
+  ObjectPool(const ObjectPool &) = delete;
+  ObjectPool &operator=(const ObjectPool &) = delete;
+
+  /** Constructs a T from args, returns nullptr if the pool is exhausted */
+  template <class... Args>
+  T *create(Args &&... args)
+  {
+    if (not m_free) {
+      return nullptr;
+    }
+    Slot *slot = m_free;
+    m_free = slot->next;
+    m_used++;
+    return new (slot->storage) T(static_cast<Args &&>(args)...);
+  }
+  /** Destroys an object created by this pool, nullptr is ignored */
+  void destroy(T *obj)
+  {
+    if (not obj) {
+      return;
+    }
+    obj->~T();
+    Slot *slot = reinterpret_cast<Slot *>(obj);
+    slot->next = m_free;
+    m_free = slot;
+    m_used--;
+  }
+  bool owns(const T *obj) const
+  {
+    auto p = reinterpret_cast<const Slot *>(obj);
+    return p >= m_slots and p < m_slots + N;
+  }
+  size_t used() const
+  {
+    return m_used;
+  }
+  size_t available() const
+  {
+    return N - m_used;
+  }
+  static constexpr size_t capacity()
+  {
+    return N;
+  }
+private:
+  union Slot
+  {
+    Slot *next;
+    alignas(T) unsigned char storage[sizeof(T)];
+  };
+
+  Slot m_slots[N];
+  Slot *m_free;
+  size_t m_used;
+};
+
+template <class ClockT> class TaskList;
+
+/** Node of a TaskList, see Listed */
+template <class ClockT>
+class TaskHook
+  : public ListHook
+{
+public:
+  typedef typename ClockT::Ticks Ticks;
+protected:
+  typedef void (*RunThunk)(TaskHook *);
+  typedef Ticks (*RemainingThunk)(const TaskHook *);
+
+  TaskHook(RunThunk run, RemainingThunk remaining)
+    : m_run(run)
+    , m_remaining(remaining)
+  {}
+private:
+  friend class TaskList<ClockT>;
+
+  RunThunk m_run;
+  RemainingThunk m_remaining;
+};
+
+/** T, anything providing run() and remaining() like the periodicals and
+ * TimerBase, with a TaskHook embedded so it can be put into a TaskList.
+ * The constructor arguments are passed on to T.
+ *
+ * The hook is opt-in so plain Timers and Periodicals keep their size.
+ * run() and remaining() are called through T, so virtual overrides in
+ * classes derived from Listed<T> are honoured.
+ */
+template <class T>
+class Listed
+  : public T
+  , public TaskHook<typename T::Clock>
+{
+  typedef TaskHook<typename T::Clock> Hook;
+public:
+  template <class... Args>
+  explicit Listed(Args &&... args)
+    : T(static_cast<Args &&>(args)...)
+    , Hook(&runThunk, &remainingThunk)
+  {}
+private:
+  static void runThunk(Hook *hook)
+  {
+    static_cast<T &>(*static_cast<Listed *>(hook)).run();
+  }
+  static typename Hook::Ticks remainingThunk(const Hook *hook)
+  {
+    return static_cast<const T &>(*static_cast<const Listed *>(hook)).remaining();
+  }
+};
+
+/** Registry of Listed tasks which come and go at runtime. Adding and
+ * removing are O(1) and allocation-free, a task leaves the list on its
+ * own when it is destroyed, and run() walks the registered tasks only.
+ *
+ * A task may remove or destroy itself while it runs, but no other task.
+ * TaskList provides run() and remaining() and can be registered with a
+ * Scheduler, which needs a reschedule() after tasks were added from
+ * outside of a scheduled callback.
+ *
+ * @code{.cpp}
+    struct Session : ew::TimerBase<Session>
+    {
+      Session(Client c) : TimerBase<Session>(30000), client(c) {}
+      void onExpired();
+      Client client;
+    };
+    ew::ObjectPool<ew::Listed<Session>, 8> sessions;
+    ew::TaskList<> tasks;
+
+    void onConnect(Client c)
+    {
+      if (auto s = sessions.create(c)) {
+        s->start();
+        tasks.add(*s);
+      }
+    }
+    void Session::onExpired()
+    {
+      client.stop();
+      sessions.destroy(static_cast<ew::Listed<Session> *>(this));
+    }
+   @endcode
+ */
+template <class ClockT = MillisClock>
+class TaskList
+{
+public:
+  typedef ClockT Clock;
+  typedef TaskHook<Clock> Hook;
+  typedef typename Hook::Ticks Ticks;
+
+  TaskList() {}
+  TaskList(const TaskList &) = delete;
+  TaskList &operator=(const TaskList &) = delete;
+
+  void add(Hook &task)
+  {
+    m_tasks.pushBack(task);
+  }
+  void remove(Hook &task)
+  {
+    m_tasks.remove(task);
+  }
+  /** Runs every registered task */
+  void run()
+  {
+    for (auto it = m_tasks.begin(); it != m_tasks.end(); ) {
+      Hook &task = *it++;
+      task.m_run(&task);
+    }
+  }
+  /** Ticks until the earliest task is due, Never if there is none */
+  Ticks remaining() const
+  {
+    Ticks min = TickTraits<Ticks>::Never;
+    for (const Hook &task : m_tasks) {
+      Ticks r = task.m_remaining(&task);
+      if (r < min) {
+        if (not r) {
+          return 0;
+        }
+        min = r;
+      }
+    }
+    return min;
+  }
+  bool empty() const
+  {
+    return m_tasks.empty();
+  }
+  size_t size() const
+  {
+    return m_tasks.size();
+  }
+private:
+  IntrusiveList<Hook> m_tasks;
+};
+
+} // namespace ew
@@ -0,0 +1,261 @@
+/* Task set fixed at compile time
+ *
+ * EwTaskSet.h
+ *
+ *  Created on: Oct 14, 2026
+ */
+
+#pragma once
+
+#include "EwUtil.h"
+
+namespace ew {
+namespace detail {
+
+template <bool Cond, class A, class B> struct Conditional           { typedef A type; };
+template <class A, class B>            struct Conditional<false, A, B> { typedef B type; };
+
+/** true for pointers to const, which &T::PeriodMs is for a static
+ * constant but not for a data member
+ */
+template <class P> struct IsConstPointer            { static const bool value = false; };
+template <class U> struct IsConstPointer<const U *> { static const bool value = true; };
+
+/** Period of a task type as sort key: its PeriodMs if it declares one as
+ * static constant, otherwise it goes last.
+ */
+template <class T, class = void>
+struct TaskPeriod
+{
+  static const unsigned long value = ULONG_MAX;
+};
+template <class T>
+struct TaskPeriod<T, typename EnableIf<IsConstPointer<decltype(&T::PeriodMs)>::value>::type>
+{
+  static const unsigned long value = T::PeriodMs;
+};
+
+/* A task's own run(now) and remaining(now) if it has them, e.g. those of
+ * AdaptivePeriodicalBase, otherwise PeriodicalBase's, which a run() or
+ * remaining() declared by the task hides.
+ */
+template <class T, class Ticks>
+auto runTask(T &task, Ticks now, int) -> decltype(task.run(now), void())
+{
+  task.run(now);
+}
+template <class T, class C, class S, PeriodicalModes::Phase P, class Ticks>
+void runTask(PeriodicalBase<T, C, S, P> &task, Ticks now, long)
+{
+  task.PeriodicalBase<T, C, S, P>::run(now);
+}
+template <class T, class Ticks>
+auto taskRemaining(const T &task, Ticks now, int) -> decltype(task.remaining(now))
+{
+  return task.remaining(now);
+}
+template <class T, class C, class S, PeriodicalModes::Phase P, class Ticks>
+Ticks taskRemaining(const PeriodicalBase<T, C, S, P> &task, Ticks now, long)
+{
+  return task.PeriodicalBase<T, C, S, P>::remaining(now);
+}
+
+template <class... Ts> struct TypeList {};
+
+template <class T, class List> struct Prepend;
+template <class T, class... Ts>
+struct Prepend<T, TypeList<Ts...> >
+{
+  typedef TypeList<T, Ts...> type;
+};
+
+/* Insertion sort by TaskPeriod, stable so tasks of equal period keep their
+ * order
+ */
+template <class T, class List> struct InsertByPeriod;
+template <class T>
+struct InsertByPeriod<T, TypeList<> >
+{
+  typedef TypeList<T> type;
+};
+template <class T, class H, class... Ts>
+struct InsertByPeriod<T, TypeList<H, Ts...> >
+{
+  typedef typename Conditional<(TaskPeriod<T>::value <= TaskPeriod<H>::value),
+                               TypeList<T, H, Ts...>,
+                               typename Prepend<H, typename InsertByPeriod<T, TypeList<Ts...> >::type>::type
+                              >::type type;
+};
+
+template <class List> struct SortByPeriod;
+template <>
+struct SortByPeriod<TypeList<> >
+{
+  typedef TypeList<> type;
+};
+template <class H, class... Ts>
+struct SortByPeriod<TypeList<H, Ts...> >
+{
+  typedef typename InsertByPeriod<H, typename SortByPeriod<TypeList<Ts...> >::type>::type type;
+};
+
+template <class T> struct TypeTag {};
+
+/** The tasks as members of one object, run in list order */
+template <class List> class TaskStorage;
+template <>
+class TaskStorage<TypeList<> >
+{
+public:
+  template <class Ticks>
+  void run(Ticks) {}
+  template <class Ticks>
+  Ticks remaining(Ticks, Ticks min) const
+  {
+    return min;
+  }
+  void get();
+  template <class U>
+  struct ClockOf
+  {
+    typedef typename U::Clock type;
+  };
+};
+template <class H, class... Ts>
+class TaskStorage<TypeList<H, Ts...> >
+  : public TaskStorage<TypeList<Ts...> >
+{
+  typedef TaskStorage<TypeList<Ts...> > Rest;
+public:
+  typedef H Front;
+  static_assert(IsSame<typename H::Clock, typename Rest::template ClockOf<H>::type>::value,
+                "all tasks of a TaskSet have to run on the same clock");
+
+  template <class Ticks>
+  void run(Ticks now)
+  {
+    runTask(m_task, now, 0);
+    Rest::run(now);
+  }
+  template <class Ticks>
+  Ticks remaining(Ticks now, Ticks min) const
+  {
+    Ticks r = taskRemaining(m_task, now, 0);
+    if (r < min) {
+      if (not r) {
+        return 0;
+      }
+      min = r;
+    }
+    return Rest::remaining(now, min);
+  }
+  using Rest::get;
+  H &get(TypeTag<H>)
+  {
+    return m_task;
+  }
+  const H &get(TypeTag<H>) const
+  {
+    return m_task;
+  }
+  /** Clock of the next task, U's own at the end of the list */
+  template <class U>
+  struct ClockOf
+  {
+    typedef typename H::Clock type;
+  };
+private:
+  H m_task;
+};
+
+} // namespace detail
+
+/** Set of tasks derived from PeriodicalBase, fixed at compile time and
+ * without any indirection: the tasks are members of the set, run() calls
+ * each task's run(now) directly with one clock sample for all, which the
+ * compiler can inline completely. Nothing is virtual, nothing on the heap.
+ *
+ * Task types declaring a static constant PeriodMs are sorted by it at
+ * compile time, the fastest first, the others follow in the order given.
+ * Every type may appear once, get<T>() returns the task of type T. All
+ * tasks have to run on the same clock.
+ *
+ * A task's own run(now) is called if it declares one. A run() of its own
+ * without the now parameter is bypassed though: the set calls
+ * PeriodicalBase::run(now) instead, so code in such a run() is skipped.
+ * Move it into task() or give it the now parameter.
+ *
+ * The set provides run() and remaining(), so it plugs into a Scheduler as
+ * a single task which wakes up for the earliest of its tasks.
+ *
+ * @code{.cpp}
+    struct Blink : ew::PeriodicalBase<Blink>
+    {
+      static const unsigned long PeriodMs = 500;
+      Blink() : PeriodicalBase<Blink>(PeriodMs) {}
+      void task() { ... }
+    };
+    ...
+    ew::TaskSet<Report, Blink, Sample> tasks;
+
+    void setup()
+    {
+      scheduler.add(tasks);
+    }
+   @endcode
+ */
+template <class... Tasks>
+class TaskSet
+{
+  static_assert(sizeof...(Tasks) > 0, "a TaskSet needs at least one task");
+public:
+  typedef typename detail::SortByPeriod<detail::TypeList<Tasks...> >::type Order;
+  typedef detail::TaskStorage<Order> Storage;
+  typedef typename Storage::template ClockOf<void>::type Clock;
+  typedef typename Clock::Ticks Ticks;
+
+  /** Shortest PeriodMs declared by a task, ULONG_MAX if there is none:
+   * the set never needs to be polled more often.
+   */
+  static const unsigned long MinPeriodMs = detail::TaskPeriod<typename Storage::Front>::value;
+
+  static constexpr size_t size()
+  {
+    return sizeof...(Tasks);
+  }
+  /** Runs every task which is due, in period order */
+  void run()
+  {
+    m_tasks.run(Clock::now());
+  }
+  void run(Ticks now)
+  {
+    m_tasks.run(now);
+  }
+  /** Ticks until the earliest task is due, zero if one is due now */
+  Ticks remaining() const
+  {
+    return remaining(Clock::now());
+  }
+  Ticks remaining(Ticks now) const
+  {
+    return m_tasks.remaining(now, TickTraits<Ticks>::Never);
+  }
+  template <class T>
+  T &get()
+  {
+    return m_tasks.get(detail::TypeTag<T>());
+  }
+  template <class T>
+  const T &get() const
+  {
+    return m_tasks.get(detail::TypeTag<T>());
+  }
+private:
+  Storage m_tasks;
+};
+
+template <class... Tasks>
+const unsigned long TaskSet<Tasks...>::MinPeriodMs;
+
+} // namespace ew
@@ -0,0 +1,210 @@
+/* Jitter and overrun instrumentation for periodic tasks
+ *
+ * EwTaskStats.h
+ *
+ *  Created on: Oct 14, 2026
+ */
+
+#pragma once
+
+#include "EwUtil.h"
+
+namespace ew {
+
+/** Statistics policy for PeriodicalBase recording how late a task fires
+ * and how long it runs.
+ *
+ * Every TaskStats instance registers itself in a global list on
+ * construction so all of them can be dumped at once:
+ *
+ * @code{.cpp}
+    class Sampler
+      : public PeriodicalBase<Sampler, ew::MillisClock, ew::TaskStats>
+    {
+    public:
+      Sampler()
+        : PeriodicalBase<Sampler, ew::MillisClock, ew::TaskStats>(10)
+      {
+        stats().setName("sampler");
+      }
+      void task();
+    };
+    ...
+    using namespace ew;
+    Serial << TaskStats::All();
+   @endcode
+ *
+ * Lateness is counted in ticks of the task's clock, saturating at
+ * ULONG_MAX on 64-bit clocks, execution times in microseconds. A run is
+ * an overrun if it took longer than the period. The histogram counts
+ * execution times in power-of-two buckets, the first one covering
+ * everything below 2^FirstBucketShift us and the last one everything
+ * above.
+ */
+class TaskStats
+{
+public:
+  static const uint8_t NumBuckets = 10;
+  static const uint8_t FirstBucketShift = 4;
+
+  /** Tag to print all registered TaskStats */
+  struct All {};
+
+  TaskStats()
+    : m_name(nullptr)
+    , m_next(head())
+  {
+    head() = this;
+    clear();
+  }
+  ~TaskStats()
+  {
+    for (TaskStats **p = &head(); *p; p = &(*p)->m_next) {
+      if (*p == this) {
+        *p = m_next;
+        break;
+      }
+    }
+  }
+  TaskStats(const TaskStats &) = delete;
+  TaskStats &operator=(const TaskStats &) = delete;
+
+  /** Statistics policy interface of PeriodicalBase */
+  template <class ClockT>
+  unsigned long enter(typename ClockT::Ticks late)
+  {
+    unsigned long lateness = late > ULONG_MAX ? ULONG_MAX : static_cast<unsigned long>(late);
+    if (lateness < m_minLate) {
+      m_minLate = lateness;
+    }
+    if (lateness > m_maxLate) {
+      m_maxLate = lateness;
+    }
+    m_sumLate += lateness;
+    return micros();
+  }
+  template <class ClockT>
+  void leave(unsigned long start, typename ClockT::Ticks period)
+  {
+    unsigned long exec = micros() - start;
+    unsigned long periodUs = toUs<ClockT>(period);
+    m_count++;
+    if (exec < m_minExec) {
+      m_minExec = exec;
+    }
+    if (exec > m_maxExec) {
+      m_maxExec = exec;
+    }
+    m_sumExec += exec;
+    if (exec > periodUs) {
+      m_overruns++;
+    }
+    uint8_t bucket = 0;
+    for (exec >>= FirstBucketShift; exec and bucket < NumBuckets - 1; exec >>= 1) {
+      bucket++;
+    }
+    m_histogram[bucket]++;
+  }
+  void clear()
+  {
+    m_count = m_overruns = 0;
+    m_minLate = m_minExec = ULONG_MAX;
+    m_maxLate = m_maxExec = 0;
+    m_sumLate = m_sumExec = 0;
+    for (auto &h : m_histogram) {
+      h = 0;
+    }
+  }
+
+  void setName(const char *name)
+  {
+    m_name = name;
+  }
+  const char *getName() const
+  {
+    return m_name ? m_name : "<task>";
+  }
+  unsigned long count() const       { return m_count; }
+  unsigned long overruns() const    { return m_overruns; }
+  unsigned long minLateness() const { return m_count ? m_minLate : 0; }
+  unsigned long maxLateness() const { return m_maxLate; }
+  unsigned long meanLateness() const
+  {
+    return m_count ? static_cast<unsigned long>(m_sumLate / m_count) : 0;
+  }
+  unsigned long minExecUs() const   { return m_count ? m_minExec : 0; }
+  unsigned long maxExecUs() const   { return m_maxExec; }
+  unsigned long meanExecUs() const
+  {
+    return m_count ? static_cast<unsigned long>(m_sumExec / m_count) : 0;
+  }
+  unsigned long bucket(uint8_t i) const
+  {
+    return i < NumBuckets ? m_histogram[i] : 0;
+  }
+
+  static const TaskStats *first()
+  {
+    return head();
+  }
+  const TaskStats *next() const
+  {
+    return m_next;
+  }
+
+private:
+  /** period in us, ULONG_MAX for periods beyond the range of micros() */
+  template <class ClockT>
+  static unsigned long toUs(typename ClockT::Ticks period)
+  {
+    if (period / ClockT::fromMs(1) >= ULONG_MAX / 1000UL) {
+      return ULONG_MAX;
+    }
+    return ClockT::toUs(period);
+  }
+
+  static TaskStats *&head()
+  {
+    static TaskStats *s_head = nullptr;
+    return s_head;
+  }
+
+  const char *m_name;
+  TaskStats *m_next;
+  unsigned long m_count;
+  unsigned long m_overruns;
+  unsigned long m_minLate, m_maxLate;
+  unsigned long m_minExec, m_maxExec;
+  unsigned long long m_sumLate, m_sumExec;
+  unsigned long m_histogram[NumBuckets];
+};
+
+inline Print &
+operator <<(Print &prt, const TaskStats &stats)
+{
+  prt << stats.getName()
+      << ": n " << stats.count()
+      << ", late " << stats.minLateness()
+      << '/' << stats.meanLateness()
+      << '/' << stats.maxLateness()
+      << ", exec us " << stats.minExecUs()
+      << '/' << stats.meanExecUs()
+      << '/' << stats.maxExecUs()
+      << ", overruns " << stats.overruns()
+      << ", hist";
+  for (uint8_t i = 0; i < TaskStats::NumBuckets; i++) {
+    prt << ' ' << stats.bucket(i);
+  }
+  return prt;
+}
+
+inline Print &
+operator <<(Print &prt, const TaskStats::All &)
+{
+  for (auto s = TaskStats::first(); s; s = s->next()) {
+    prt << *s << "\r\n";
+  }
+  return prt;
+}
+
+} // namespace ew
@@ -0,0 +1,275 @@
+/* Structure-of-arrays container for many timers
+ *
+ * EwTimerArray.h
+ *
+ *  Created on: Oct 14, 2026
+ */
+
+#pragma once
+
+#include "EwUtil.h"
+
+#if defined(__ARM_NEON)
+# include <arm_neon.h>
+# define EW_HAVE_NEON 1
+#else
+# define EW_HAVE_NEON 0
+#endif
+
+namespace ew {
+
+namespace detail {
+
+/** Mask of the lanes [0, n) with more than timeout[i] ticks elapsed since
+ * last[i] at now and a non-zero timeout, n <= 32. Written without branches
+ * so the compiler can vectorise it.
+ */
+template <class Ticks, class Timeout,
+          bool Neon = EW_HAVE_NEON and sizeof(Ticks) == 4 and sizeof(Timeout) == 4>
+struct ExpiredLanes
+{
+  static uint32_t
+  get(const Ticks *last, const Timeout *timeout, size_t n, Ticks now)
+  {
+    uint32_t mask = 0;
+    for (size_t i = 0; i < n; i++) {
+      Ticks elapsed = now - last[i];
+      mask |= uint32_t((elapsed > timeout[i]) & (timeout[i] != 0)) << i;
+    }
+    return mask;
+  }
+};
+
+#if EW_HAVE_NEON
+/** Four 32-bit lanes per NEON compare */
+template <class Ticks, class Timeout>
+struct ExpiredLanes<Ticks, Timeout, true>
+{
+  static uint32_t
+  get(const Ticks *last, const Timeout *timeout, size_t n, Ticks now)
+  {
+    static const uint32_t weights[4] = {1, 2, 4, 8};
+    const uint32x4_t w = vld1q_u32(weights);
+    const uint32x4_t t0 = vdupq_n_u32(now);
+    uint32_t mask = 0;
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+      uint32x4_t elapsed = vsubq_u32(t0, vld1q_u32(reinterpret_cast<const uint32_t *>(last + i)));
+      uint32x4_t to = vld1q_u32(reinterpret_cast<const uint32_t *>(timeout + i));
+      uint32x4_t m = vandq_u32(vandq_u32(vcgtq_u32(elapsed, to), vtstq_u32(to, to)), w);
+      uint32x2_t s = vadd_u32(vget_low_u32(m), vget_high_u32(m));
+      mask |= vget_lane_u32(vpadd_u32(s, s), 0) << i;
+    }
+    if (i < n) {
+      mask |= ExpiredLanes<Ticks, Timeout, false>::get(last + i, timeout + i, n - i, now) << i;
+    }
+    return mask;
+  }
+};
+#endif
+
+} // namespace detail
+
+/** N timers with the semantics of Timer, addressed by index, storing
+ * their timestamps, timeouts and flags in separate contiguous arrays.
+ *
+ * A timer costs sizeof(Ticks) + sizeof(TimeoutT) bytes plus two bits, so
+ * 100 millisecond timers with 16-bit timeouts take 600 bytes plus 32 bytes
+ * of flags instead of 1000 to 1200 bytes as individual Timers.
+ *
+ * forEachExpired() and expiredMask() check the timers 32 at a time in a
+ * branch-free loop over the dense arrays, using NEON where available,
+ * skip 32 stopped timers with a single compare and restart the expired
+ * periodic ones in bulk.
+ *
+ * @code{.cpp}
+    ew::TimerArray<100, ew::MillisClock, uint16_t> liveness;
+
+    liveness.start(node, 5000);
+    ...
+    liveness.forEachExpired([](size_t node) {
+      markDead(node);
+    });
+   @endcode
+ */
+template <size_t N, class ClockT = MillisClock, class TimeoutT = typename ClockT::Ticks>
+class TimerArray
+{
+public:
+  typedef ClockT Clock;
+  typedef typename Clock::Ticks Ticks;
+  typedef TimeoutT Timeout;
+  typedef TimerModes::Mode Mode;
+
+  static const size_t NumWords = (N + 31) / 32;
+  static const TimeoutT MaxTimeout = static_cast<TimeoutT>(~TimeoutT(0));
+
+  TimerArray()
+  {
+    for (size_t i = 0; i < N; i++) {
+      m_last[i] = 0;
+      m_timeout[i] = 0;
+    }
+    for (size_t w = 0; w < NumWords; w++) {
+      m_running[w] = m_periodic[w] = 0;
+    }
+  }
+  static constexpr size_t size()
+  {
+    return N;
+  }
+  /** Restarts timer i with its previous timeout and mode */
+  void start(size_t i)
+  {
+    m_last[i] = Clock::now();
+    m_running[word(i)] |= bit(i);
+  }
+  /** Timeouts beyond MaxTimeout are clamped to it */
+  void start(size_t i, Ticks timeout, Mode mode = TimerModes::OneShot)
+  {
+    m_timeout[i] = clamp(timeout);
+    setMode(i, mode);
+    start(i);
+  }
+  void stop(size_t i)
+  {
+    m_running[word(i)] &= ~bit(i);
+  }
+  bool running(size_t i) const
+  {
+    return m_running[word(i)] & bit(i);
+  }
+  void setTimeout(size_t i, Ticks timeout)
+  {
+    m_timeout[i] = clamp(timeout);
+  }
+  Timeout getTimeout(size_t i) const
+  {
+    return m_timeout[i];
+  }
+  void setMode(size_t i, Mode mode)
+  {
+    if (mode == TimerModes::Periodic) {
+      m_periodic[word(i)] |= bit(i);
+    } else {
+      m_periodic[word(i)] &= ~bit(i);
+    }
+  }
+  Mode getMode(size_t i) const
+  {
+    return m_periodic[word(i)] & bit(i) ? TimerModes::Periodic : TimerModes::OneShot;
+  }
+  /** true once timer i expired, OneShot timers stop, Periodic ones
+   * restart.
+   */
+  bool expired(size_t i)
+  {
+    return expired(i, Clock::now());
+  }
+  bool expired(size_t i, Ticks now)
+  {
+    if (not running(i) or not m_timeout[i] or now - m_last[i] <= m_timeout[i]) {
+      return false;
+    }
+    if (m_periodic[word(i)] & bit(i)) {
+      m_last[i] = now;
+    } else {
+      stop(i);
+    }
+    return true;
+  }
+  /** Ticks until timer i expires, zero if it has expired and Never if it
+   * is stopped or has no timeout.
+   */
+  Ticks remaining(size_t i) const
+  {
+    if (not running(i) or not m_timeout[i]) {
+      return TickTraits<Ticks>::Never;
+    }
+    Ticks elapsed = Clock::now() - m_last[i];
+    return elapsed > m_timeout[i] ? 0 : m_timeout[i] - elapsed + 1;
+  }
+  /** Checks the up to 32 timers of bitset word w at once. Returns the
+   * mask of the expired ones, bit b standing for timer 32 * w + b, and
+   * restarts the periodic and stops the one-shot ones among them.
+   */
+  uint32_t expiredMask(size_t w, Ticks now)
+  {
+    uint32_t running = m_running[w];
+    if (not running) {
+      return 0;
+    }
+    size_t first = 32 * w;
+    size_t n = N - first < 32 ? N - first : 32;
+    uint32_t mask = running & detail::ExpiredLanes<Ticks, Timeout>::get(
+      m_last + first, m_timeout + first, n, now);
+    m_running[w] = running & ~(mask & ~m_periodic[w]);
+    for (uint32_t p = mask & m_periodic[w]; p; p &= p - 1) {
+      m_last[first + __builtin_ctzl(p)] = now;
+    }
+    return mask;
+  }
+  /** Fills mask with the expired timers of all words, see above, and
+   * returns their number.
+   */
+  size_t expiredMask(uint32_t (&mask)[NumWords])
+  {
+    Ticks now = Clock::now();
+    size_t n = 0;
+    for (size_t w = 0; w < NumWords; w++) {
+      mask[w] = expiredMask(w, now);
+      n += __builtin_popcountl(mask[w]);
+    }
+    return n;
+  }
+  /** Calls f(i) for every expired timer i in index order and returns
+   * their number. All timers are checked against the same point in time
+   * before the first call, f may start and stop any timer.
+   */
+  template <class Fn>
+  size_t forEachExpired(Fn &&f)
+  {
+    uint32_t mask[NumWords];
+    size_t n = expiredMask(mask);
+    for (size_t w = 0; w < NumWords; w++) {
+      for (uint32_t m = mask[w]; m; m &= m - 1) {
+        f(32 * w + __builtin_ctzl(m));
+      }
+    }
+    return n;
+  }
+  /** Number of running timers */
+  size_t count() const
+  {
+    size_t n = 0;
+    for (size_t w = 0; w < NumWords; w++) {
+      n += __builtin_popcountl(m_running[w]);
+    }
+    return n;
+  }
+protected:
+  static Timeout clamp(Ticks timeout)
+  {
+    return timeout > Ticks(MaxTimeout) ? MaxTimeout : static_cast<Timeout>(timeout);
+  }
+  static size_t word(size_t i)
+  {
+    return i / 32;
+  }
+  static uint32_t bit(size_t i)
+  {
+    return uint32_t(1) << (i % 32);
+  }
+
+  Ticks m_last[N];
+  Timeout m_timeout[N];
+  uint32_t m_running[NumWords];
+  uint32_t m_periodic[NumWords];
+};
+
+template <size_t N, class ClockT, class TimeoutT>
+const size_t TimerArray<N, ClockT, TimeoutT>::NumWords;
+template <size_t N, class ClockT, class TimeoutT>
+const TimeoutT TimerArray<N, ClockT, TimeoutT>::MaxTimeout;
+
+} // namespace ew
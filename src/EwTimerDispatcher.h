@@ -0,0 +1,145 @@
+/* Timers calling back from one central dispatcher
+ *
+ * EwTimerDispatcher.h
+ *
+ *  Created on: Oct 14, 2026
+ */
+
+#pragma once
+
+#include "EwTimerQueue.h"
+
+namespace ew {
+
+/** Up to Capacity timers with callbacks dispatched from one place instead
+ * of an if (timer.expired()) per timer scattered over the loop.
+ *
+ * A timer is a function pointer and a context, either added to a free slot
+ * or attached to a fixed id. run() reads the clock once, collects every
+ * timer which expired and calls their callbacks back to back in deadline
+ * order. Expiry follows the semantics of Timer, see TimerQueue.
+ *
+ * The dispatcher provides run() and remaining(), so it can be registered
+ * with a Scheduler as a single task. Callbacks starting or stopping timers
+ * of the dispatcher are picked up by the scheduler, timers started from
+ * outside a callback need a reschedule() of the scheduler.
+ *
+ * @code{.cpp}
+    ew::TimerDispatcher<16> timers;
+
+    void onBlink(void *ctx)
+    {
+      static_cast<Led *>(ctx)->toggle();
+    }
+    void setup()
+    {
+      auto blink = timers.add(onBlink, &led);
+      timers.start(blink, 500, ew::TimerModes::Periodic);
+    }
+    void loop()
+    {
+      timers.run();
+    }
+   @endcode
+ */
+template <size_t Capacity, class ClockT = MillisClock>
+class TimerDispatcher
+{
+public:
+  typedef ClockT Clock;
+  typedef TimerQueue<Capacity, Clock> Queue;
+  typedef typename Queue::Ticks Ticks;
+  typedef typename Queue::Id Id;
+  typedef typename Queue::Mode Mode;
+  typedef void (*Callback)(void *ctx);
+
+  static const Id None = Queue::None;
+
+  TimerDispatcher()
+  {
+    for (size_t i = 0; i < Capacity; i++) {
+      m_entries[i] = Entry{nullptr, nullptr};
+    }
+  }
+  TimerDispatcher(const TimerDispatcher &) = delete;
+  TimerDispatcher &operator=(const TimerDispatcher &) = delete;
+
+  /** Puts callback into a free slot and returns its id, None if all
+   * slots are taken. The timer is not started.
+   */
+  Id add(Callback callback, void *ctx = nullptr)
+  {
+    for (size_t i = 0; i < Capacity; i++) {
+      if (not m_entries[i].callback) {
+        m_entries[i] = Entry{callback, ctx};
+        return static_cast<Id>(i);
+      }
+    }
+    return None;
+  }
+  /** Stops timer id and frees its slot */
+  void remove(Id id)
+  {
+    m_queue.stop(id);
+    m_entries[id] = Entry{nullptr, nullptr};
+  }
+  /** Sets the callback of the timer with the fixed id */
+  void attach(Id id, Callback callback, void *ctx = nullptr)
+  {
+    m_entries[id] = Entry{callback, ctx};
+  }
+  void start(Id id)
+  {
+    m_queue.start(id);
+  }
+  void start(Id id, Ticks timeout, Mode mode = TimerModes::OneShot)
+  {
+    m_queue.start(id, timeout, mode);
+  }
+  void stop(Id id)
+  {
+    m_queue.stop(id);
+  }
+  bool running(Id id) const
+  {
+    return m_queue.running(id);
+  }
+  Ticks getTimeout(Id id) const
+  {
+    return m_queue.getTimeout(id);
+  }
+  /** Ticks until the earliest timer expires, see TimerQueue */
+  Ticks remaining() const
+  {
+    return m_queue.remaining();
+  }
+  /** Calls the callbacks of all expired timers and returns their number */
+  size_t run()
+  {
+    return m_queue.poll([this](Id id) {
+      const Entry &e = m_entries[id];
+      if (e.callback) {
+        e.callback(e.ctx);
+      }
+    });
+  }
+  /** The queue behind the dispatcher */
+  const Queue &queue() const
+  {
+    return m_queue;
+  }
+private:
+  struct Entry
+  {
+    Callback callback;
+    void *ctx;
+  };
+
+  Queue m_queue;
+  Entry m_entries[Capacity];
+};
+
+template <size_t Capacity, class ClockT>
+const typename TimerDispatcher<Capacity, ClockT>::Id TimerDispatcher<Capacity, ClockT>::None;
+
+} // namespace ew
@@ -0,0 +1,219 @@
+/* Deadline queue for large numbers of timers
+ *
+ * EwTimerQueue.h
+ *
+ *  Created on: Oct 14, 2026
+ */
+
+#pragma once
+
+#include "EwUtil.h"
+
+namespace ew {
+
+/** Fixed-capacity binary min-heap of timer deadlines without any heap
+ * allocation.
+ *
+ * Timers are addressed by an id in the range [0, Capacity), e.g. the index
+ * of a connection. start() and stop() are O(log n), poll() only touches the
+ * timers which actually expired and reports them in deadline order.
+ *
+ * Expiry follows the semantics of Timer: a timer expires once more than
+ * its timeout has elapsed since it was started, OneShot timers are stopped
+ * and Periodic timers restarted on expiry and a timeout of zero never
+ * expires. All comparisons are rollover-safe as long as no timeout exceeds
+ * Traits::MaxDelta ticks (~24 days on the millisecond clock).
+ *
+ * @code{.cpp}
+    ew::TimerQueue<64> timeouts;
+
+    timeouts.start(connectionId, 5000);
+    ...
+    timeouts.poll([](uint8_t id) {
+      closeConnection(id);
+    });
+   @endcode
+ */
+template <size_t Capacity, class ClockT = MillisClock>
+class TimerQueue
+{
+public:
+  typedef ClockT Clock;
+  typedef typename Clock::Ticks Ticks;
+  typedef TickTraits<Ticks> Traits;
+  typedef TimerModes::Mode Mode;
+  typedef typename detail::IndexType<Capacity>::type Id;
+
+  static const Id None = static_cast<Id>(~Id(0));
+
+  TimerQueue()
+    : m_size(0)
+  {
+    for (size_t i = 0; i < Capacity; i++) {
+      m_slots[i].timeout = 0;
+      m_slots[i].mode = TimerModes::OneShot;
+      m_heap[i] = 0;
+      m_pos[i] = None;
+    }
+  }
+  /** Restarts the timer with its previous timeout and mode. */
+  void start(Id id)
+  {
+    start(id, m_slots[id].timeout, static_cast<Mode>(m_slots[id].mode));
+  }
+  void start(Id id, Ticks timeout, Mode mode = TimerModes::OneShot)
+  {
+    Slot &slot = m_slots[id];
+    slot.timeout = timeout;
+    slot.mode = mode;
+    if (not timeout) {
+      stop(id);
+      return;
+    }
+    slot.deadline = Clock::now() + timeout;
+    if (m_pos[id] == None) {
+      push(id);
+    } else {
+      update(m_pos[id]);
+    }
+  }
+  void stop(Id id)
+  {
+    auto pos = m_pos[id];
+    if (pos == None) {
+      return;
+    }
+    m_pos[id] = None;
+    if (--m_size != pos) {
+      place(pos, m_heap[m_size]);
+      update(pos);
+    }
+  }
+  bool running(Id id) const
+  {
+    return m_pos[id] != None;
+  }
+  Ticks getTimeout(Id id) const
+  {
+    return m_slots[id].timeout;
+  }
+  /** Number of running timers */
+  size_t size() const
+  {
+    return m_size;
+  }
+  bool empty() const
+  {
+    return not m_size;
+  }
+  /** Ticks until the earliest timer expires, zero if one expired
+   * already and Traits::Never if no timer is running.
+   */
+  Ticks remaining() const
+  {
+    if (not m_size) {
+      return Traits::Never;
+    }
+    Ticks deadline = m_slots[m_heap[0]].deadline;
+    Ticks now = Clock::now();
+    return Traits::before(deadline, now) ? 0 : deadline - now + 1;
+  }
+  /** Calls f(id) for every expired timer in deadline order and returns
+   * the number of expired timers. The callback may start and stop any
+   * timer, including the one it is called for.
+   */
+  template <class Fn>
+  size_t poll(Fn &&f)
+  {
+    Ticks now = Clock::now();
+    size_t n = 0;
+    while (m_size) {
+      Id id = m_heap[0];
+      Slot &slot = m_slots[id];
+      if (not Traits::before(slot.deadline, now)) {
+        break;
+      }
+      if (slot.mode == TimerModes::Periodic) {
+        slot.deadline = now + slot.timeout;
+        update(0);
+      } else {
+        stop(id);
+      }
+      n++;
+      f(id);
+    }
+    return n;
+  }
+private:
+  struct Slot
+  {
+    Ticks deadline;
+    Ticks timeout;
+    uint8_t mode;
+  };
+  bool before(Id a, Id b) const
+  {
+    return Traits::before(m_slots[a].deadline, m_slots[b].deadline);
+  }
+  void place(Id pos, Id id)
+  {
+    m_heap[pos] = id;
+    m_pos[id] = pos;
+  }
+  void push(Id id)
+  {
+    place(m_size++, id);
+    siftUp(m_size - 1);
+  }
+  /** Restores the heap property after the deadline at pos changed. */
+  void update(Id pos)
+  {
+    if (pos and before(m_heap[pos], m_heap[(pos - 1) / 2])) {
+      siftUp(pos);
+    } else {
+      siftDown(pos);
+    }
+  }
+  void siftUp(Id pos)
+  {
+    Id id = m_heap[pos];
+    while (pos) {
+      Id parent = (pos - 1) / 2;
+      if (not before(id, m_heap[parent])) {
+        break;
+      }
+      place(pos, m_heap[parent]);
+      pos = parent;
+    }
+    place(pos, id);
+  }
+  void siftDown(Id pos)
+  {
+    Id id = m_heap[pos];
+    for (;;) {
+      size_t child = 2 * size_t(pos) + 1;
+      if (child >= m_size) {
+        break;
+      }
+      if (child + 1 < m_size and before(m_heap[child + 1], m_heap[child])) {
+        child++;
+      }
+      if (not before(m_heap[child], id)) {
+        break;
+      }
+      place(pos, m_heap[child]);
+      pos = child;
+    }
+    place(pos, id);
+  }
+
+  Slot m_slots[Capacity];
+  Id m_heap[Capacity];
+  Id m_pos[Capacity];
+  size_t m_size;
+};
+
+template <size_t Capacity, class ClockT>
+const typename TimerQueue<Capacity, ClockT>::Id TimerQueue<Capacity, ClockT>::None;
+
+} // namespace ew
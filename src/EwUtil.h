@@ -9,7 +9,18 @@
 #pragma once
 
 #include <Arduino.h>
-#include <functional>
+#include <limits.h>
+#include <new>
+
+/* Not every toolchain ships the C++ standard library (e.g. plain AVR), on
+ * those Periodical falls back to an InlinePeriodical.
+ */
+#if __has_include(<functional>)
+# include <functional>
+# define EW_HAVE_STD_FUNCTION 1
+#else
+# define EW_HAVE_STD_FUNCTION 0
+#endif
 
 /** In order for the following macros to work you have to include
  * the automatically generated git-version.h header before including
@@ -28,14 +39,531 @@
 
 /* C++ 11 implementation */
 
-class Periodical
+namespace ew {
+
+namespace detail {
+
+template <class T> struct RemoveRef       { typedef T type; };
+template <class T> struct RemoveRef<T &>  { typedef T type; };
+template <class T> struct RemoveRef<T &&> { typedef T type; };
+
+template <class T> struct RemoveConst          { typedef T type; };
+template <class T> struct RemoveConst<const T> { typedef T type; };
+
+/** By-value type of T, functions become function pointers */
+template <class T>                struct DecayValue             { typedef T type; };
+template <class R, class... Args> struct DecayValue<R(Args...)> { typedef R (*type)(Args...); };
+
+template <class T> struct Decay
+{
+  typedef typename DecayValue<typename RemoveConst<typename RemoveRef<T>::type>::type>::type type;
+};
+
+/** true for null function pointers, which InlineFunction treats as empty */
+template <class T>
+bool isNullCallable(const T &)
+{
+  return false;
+}
+template <class R, class... Args>
+bool isNullCallable(R (*f)(Args...))
+{
+  return f == nullptr;
+}
+
+template <bool Cond, class T = void> struct EnableIf {};
+template <class T> struct EnableIf<true, T> { typedef T type; };
+
+template <class A, class B> struct IsSame       { static const bool value = false; };
+template <class A>          struct IsSame<A, A> { static const bool value = true; };
+
+/** Smallest unsigned type able to index Capacity elements plus one
+ * invalid marker.
+ */
+template <size_t Capacity,
+          int Size = Capacity < 0xFF ? 1 : Capacity < 0xFFFF ? 2 : 4>
+struct IndexType
+{
+  typedef uint8_t type;
+};
+template <size_t Capacity>
+struct IndexType<Capacity, 2>
+{
+  typedef uint16_t type;
+};
+template <size_t Capacity>
+struct IndexType<Capacity, 4>
+{
+  static_assert(Capacity < 0xFFFFFFFFUL, "capacity too big for a 32-bit index");
+  typedef uint32_t type;
+};
+
+} // namespace detail
+
+/** A void(void) callable with Capacity bytes of inline storage.
+ *
+ * Drop-in replacement for std::function<void(void)> which never allocates
+ * and does not need RTTI. Assigning a callable which does not fit into
+ * Capacity bytes fails to compile. Plain functions are stored as function
+ * pointers, a null function pointer leaves it empty like std::function.
+ */
+template <size_t Capacity = 2 * sizeof(void *)>
+class InlineFunction
+{
+public:
+  InlineFunction()
+    : m_ops(nullptr)
+  {}
+  InlineFunction(decltype(nullptr))
+    : m_ops(nullptr)
+  {}
+  template <class Fn,
+            class D = typename detail::Decay<Fn>::type,
+            class = typename detail::EnableIf<not detail::IsSame<D, InlineFunction>::value>::type>
+  InlineFunction(Fn &&f)
+    : m_ops(nullptr)
+  {
+    static_assert(sizeof(D) <= Capacity,
+                  "callable too big for InlineFunction, increase its capacity");
+    static_assert(alignof(D) <= alignof(Storage),
+                  "callable alignment not supported by InlineFunction");
+    if (detail::isNullCallable(static_cast<const D &>(f))) {
+      return;
+    }
+    new (m_storage.buf) D(static_cast<Fn &&>(f));
+    m_ops = &Ops<D>::ops;
+  }
+  InlineFunction(const InlineFunction &other)
+    : m_ops(other.m_ops)
+  {
+    if (m_ops) {
+      m_ops->copy(m_storage.buf, other.m_storage.buf);
+    }
+  }
+  InlineFunction(InlineFunction &&other)
+    : m_ops(other.m_ops)
+  {
+    if (m_ops) {
+      m_ops->move(m_storage.buf, other.m_storage.buf);
+    }
+  }
+  ~InlineFunction()
+  {
+    reset();
+  }
+  InlineFunction &operator=(const InlineFunction &other)
+  {
+    if (this != &other) {
+      reset();
+      m_ops = other.m_ops;
+      if (m_ops) {
+        m_ops->copy(m_storage.buf, other.m_storage.buf);
+      }
+    }
+    return *this;
+  }
+  InlineFunction &operator=(InlineFunction &&other)
+  {
+    if (this != &other) {
+      reset();
+      m_ops = other.m_ops;
+      if (m_ops) {
+        m_ops->move(m_storage.buf, other.m_storage.buf);
+      }
+    }
+    return *this;
+  }
+  explicit operator bool() const
+  {
+    return m_ops != nullptr;
+  }
+  void operator()()
+  {
+    m_ops->call(m_storage.buf);
+  }
+  void reset()
+  {
+    if (m_ops) {
+      m_ops->destroy(m_storage.buf);
+      m_ops = nullptr;
+    }
+  }
+private:
+  struct OpsTable
+  {
+    void (*call)(void *);
+    void (*copy)(void *, const void *);
+    void (*move)(void *, void *);
+    void (*destroy)(void *);
+  };
+  template <class Fn>
+  struct Ops
+  {
+    static void call(void *p)                     { (*static_cast<Fn *>(p))(); }
+    static void copy(void *dst, const void *src)  { new (dst) Fn(*static_cast<const Fn *>(src)); }
+    static void move(void *dst, void *src)        { new (dst) Fn(static_cast<Fn &&>(*static_cast<Fn *>(src))); }
+    static void destroy(void *p)                  { static_cast<Fn *>(p)->~Fn(); }
+    static const OpsTable ops;
+  };
+  union Storage
+  {
+    unsigned char buf[Capacity];
+    void *ptr;
+    long long ll;
+    double d;
+  };
+
+  Storage m_storage;
+  const OpsTable *m_ops;
+};
+
+template <size_t Capacity>
+template <class Fn>
+const typename InlineFunction<Capacity>::OpsTable InlineFunction<Capacity>::Ops<Fn>::ops = {
+  &InlineFunction<Capacity>::Ops<Fn>::call,
+  &InlineFunction<Capacity>::Ops<Fn>::copy,
+  &InlineFunction<Capacity>::Ops<Fn>::move,
+  &InlineFunction<Capacity>::Ops<Fn>::destroy,
+};
+
+/** Rollover-safe arithmetic on the unsigned tick counts of a clock. */
+template <class Ticks>
+struct TickTraits
+{
+  /** Returned by remaining() if something will never be due */
+  static const Ticks Never = static_cast<Ticks>(~Ticks(0));
+  /** Largest distance two points in time may have to be compared */
+  static const Ticks MaxDelta = Never >> 1;
+
+  /** true if a lies before b */
+  static bool before(Ticks a, Ticks b)
+  {
+    return static_cast<Ticks>(a - b) > MaxDelta;
+  }
+};
+
+template <class Ticks> const Ticks TickTraits<Ticks>::Never;
+template <class Ticks> const Ticks TickTraits<Ticks>::MaxDelta;
+
+/* Clock policies for PeriodicalBase and BasicTimer. A clock provides its
+ * Ticks type, now(), conversion from and to milliseconds and conversion to
+ * microseconds for instrumentation. Any
+ * free-running unsigned counter which wraps at the width of Ticks can be
+ * turned into a clock this way.
+ */
+
+/** Millisecond clock, the default everywhere */
+struct MillisClock
+{
+  typedef unsigned long Ticks;
+  static Ticks now()                   { return millis(); }
+  static Ticks fromMs(unsigned long ms) { return ms; }
+  static unsigned long toMs(Ticks t)    { return t; }
+  static unsigned long toUs(Ticks t)    { return t * 1000UL; }
+};
+
+/** Microsecond clock for periods in the kHz range */
+struct MicrosClock
+{
+  typedef unsigned long Ticks;
+  static Ticks now()                   { return micros(); }
+  static Ticks fromMs(unsigned long ms) { return ms * 1000UL; }
+  static unsigned long toMs(Ticks t)    { return t / 1000UL; }
+  static unsigned long toUs(Ticks t)    { return t; }
+};
+
+#if defined(ESP8266) || defined(ESP32)
+/** CPU cycle counter (ccount), wraps after 2^32 cycles */
+struct CycleClock
+{
+  typedef unsigned long Ticks;
+  static Ticks now()                   { return ESP.getCycleCount(); }
+  static Ticks fromMs(unsigned long ms) { return ms * (ESP.getCpuFreqMHz() * 1000UL); }
+  static unsigned long toMs(Ticks t)    { return t / (ESP.getCpuFreqMHz() * 1000UL); }
+  static unsigned long toUs(Ticks t)    { return t / ESP.getCpuFreqMHz(); }
+};
+#elif defined(__ARM_ARCH_7M__) || defined(__ARM_ARCH_7EM__)
+/** Cortex-M3/M4/M7 cycle counter (DWT->CYCCNT), wraps after 2^32 cycles.
+ * Call begin() once in setup() to enable the counter.
+ */
+struct CycleClock
+{
+  typedef unsigned long Ticks;
+  static void begin()
+  {
+    *reinterpret_cast<volatile uint32_t *>(0xE000EDFCUL) |= 1UL << 24; // DEMCR.TRCENA
+    *reinterpret_cast<volatile uint32_t *>(0xE0001004UL) = 0;          // DWT->CYCCNT
+    *reinterpret_cast<volatile uint32_t *>(0xE0001000UL) |= 1UL;       // DWT->CTRL.CYCCNTENA
+  }
+  static Ticks now()                   { return *reinterpret_cast<volatile uint32_t *>(0xE0001004UL); }
+  static Ticks fromMs(unsigned long ms) { return ms * (F_CPU / 1000UL); }
+  static unsigned long toMs(Ticks t)    { return t / (F_CPU / 1000UL); }
+  static unsigned long toUs(Ticks t)    { return t / (F_CPU / 1000000UL); }
+};
+#endif
+
+/** Clock returning the time its base clock had at the last update(), see
+ * Tick and MicroTick. Updated once at the top of loop() all tasks and
+ * timers polled in that pass see the same now and the base clock is read
+ * once instead of by every one of them.
+ *
+ * Tasks and timers run on it as clock policy, PeriodicalBase<MyTask,
+ * ew::Tick> or BasicTimer<ew::Tick>, or get its time passed to their
+ * run(now), expired(now) and friends. It is meant for the main loop only,
+ * a Scheduler keeps running on the real clock since it sleeps in between.
+ *
+ * @code{.cpp}
+    void loop()
+    {
+      auto now = ew::Tick::update();
+      blink.run(now);
+      if (timeout.expired(now)) {
+        ...
+      }
+    }
+   @endcode
+ */
+template <class ClockT>
+struct BasicTick
+{
+  typedef typename ClockT::Ticks Ticks;
+  typedef ClockT BaseClock;
+
+  /** Samples the base clock and returns the new now */
+  static Ticks update()
+  {
+    return sample() = ClockT::now();
+  }
+  static Ticks now()                    { return sample(); }
+  static Ticks fromMs(unsigned long ms) { return ClockT::fromMs(ms); }
+  static unsigned long toMs(Ticks t)    { return ClockT::toMs(t); }
+  static unsigned long toUs(Ticks t)    { return ClockT::toUs(t); }
+private:
+  static Ticks &sample()
+  {
+    static Ticks s_now = 0;
+    return s_now;
+  }
+};
+
+/** Millisecond clock sampled once per loop pass */
+typedef BasicTick<MillisClock> Tick;
+/** Microsecond clock sampled once per loop pass */
+typedef BasicTick<MicrosClock> MicroTick;
+
+/** Disables interrupts for its lifetime and restores the previous state
+ * afterwards. Keep the guarded code down to a few instructions.
+ *
+ * On the ESP32 it takes a spinlock as well, so it also excludes code
+ * running on the other core. IsrCriticalSection is what code running in
+ * an ISR uses to exclude the main context: It is the same on the ESP32
+ * and does nothing everywhere else, where an ISR is not interrupted by
+ * the main loop anyway.
+ *
+ * On other architectures the Arduino API offers no way to read the
+ * interrupt state. There CriticalSection counts its nesting and enables
+ * interrupts again when the outermost one ends. It must not be used where
+ * interrupts are disabled already, e.g. in an ISR, which would be left
+ * with interrupts enabled.
+ */
+class CriticalSection
+{
+public:
+#if defined(__AVR__)
+  CriticalSection() : m_sreg(SREG) { cli(); }
+  ~CriticalSection()               { SREG = m_sreg; }
+private:
+  uint8_t m_sreg;
+#elif defined(ESP32)
+  CriticalSection()  { portENTER_CRITICAL_ISR(&mux()); }
+  ~CriticalSection() { portEXIT_CRITICAL_ISR(&mux()); }
+private:
+  static portMUX_TYPE &mux()
+  {
+    static portMUX_TYPE s_mux = portMUX_INITIALIZER_UNLOCKED;
+    return s_mux;
+  }
+#elif defined(ESP8266)
+  CriticalSection() : m_ps(xt_rsil(15)) {}
+  ~CriticalSection()                    { xt_wsr_ps(m_ps); }
+private:
+  uint32_t m_ps;
+#elif defined(__arm__)
+  CriticalSection()
+  {
+    __asm__ volatile ("mrs %0, primask\n\tcpsid i" : "=r" (m_primask) :: "memory");
+  }
+  ~CriticalSection()
+  {
+    __asm__ volatile ("msr primask, %0" :: "r" (m_primask) : "memory");
+  }
+private:
+  uint32_t m_primask;
+#else
+  CriticalSection()
+  {
+    noInterrupts();
+    depth()++;
+  }
+  ~CriticalSection()
+  {
+    if (not --depth()) {
+      interrupts();
+    }
+  }
+private:
+  static uint8_t &depth()
+  {
+    static uint8_t s_depth = 0;
+    return s_depth;
+  }
+#endif
+  CriticalSection(const CriticalSection &) = delete;
+  CriticalSection &operator=(const CriticalSection &) = delete;
+};
+
+#if defined(ESP32)
+typedef CriticalSection IsrCriticalSection;
+#else
+struct IsrCriticalSection
+{
+  IsrCriticalSection() {}
+};
+#endif
+
+/** Default statistics policy of PeriodicalBase: records nothing and
+ * compiles to nothing. See TaskStats in EwTaskStats.h for the real one.
+ *
+ * A statistics policy is told the lateness of a task when it starts
+ * running and returns a start stamp which it is handed back together with
+ * the task period when the task returns. Both are in ticks of ClockT, any
+ * conversion is left to the policy so a disabled one costs nothing.
+ */
+struct NoTaskStats
+{
+  template <class ClockT>
+  unsigned long enter(typename ClockT::Ticks /* lateness */) { return 0; }
+  template <class ClockT>
+  void leave(unsigned long /* start */, typename ClockT::Ticks /* period */) {}
+};
+
+} // namespace ew
+
+/** How a periodical schedules its next run after it fired. Periodical
+ * and PeriodicalBase take it as template parameter, so the default pays
+ * nothing for the other modes.
+ *
+ * Restart (default) restarts the period when the task runs. Every late
+ * loop pass therefore stretches the period a little.
+ *
+ * The phase-locked modes advance the schedule by whole periods instead so
+ * the average rate stays exact. When falling behind by more than a period
+ * Skip drops the missed runs and continues on the original grid, Burst
+ * runs the missed ones on the following loop passes until it caught up.
+ * missed() reports the number of skipped respectively still pending runs
+ * to the task. Call reset() to re-anchor the schedule to the current time,
+ * e.g. when enabling a phase-locked periodical long after boot.
+ */
+struct PeriodicalModes
+{
+  typedef enum {
+    Restart,
+    Skip,
+    Burst,
+  } Phase;
+
+protected:
+  /** Checks if a periodical is due at now and advances its schedule */
+  template <class Ticks>
+  static bool due(Ticks now, Ticks &prev, Ticks period, uint8_t phase, Ticks &missed)
+  {
+    Ticks elapsed = now - prev;
+    if (phase == Restart) {
+      if (elapsed > period) {
+        prev = now;
+        return true;
+      }
+      return false;
+    }
+    if (elapsed < period) {
+      return false;
+    }
+    if (not period) {
+      prev = now;
+      return true;
+    }
+    Ticks behind = elapsed - period < period ? 1 : elapsed / period;
+    missed = behind - 1;
+    prev += (phase == Skip ? behind : 1) * period;
+    return true;
+  }
+  template <class Ticks>
+  static Ticks remaining(Ticks elapsed, Ticks period, uint8_t phase)
+  {
+    if (phase == Restart) {
+      return elapsed > period ? 0 : period - elapsed + 1;
+    }
+    return elapsed >= period ? 0 : period - elapsed;
+  }
+};
+
+namespace ew {
+
+namespace detail {
+
+/** The runs a phase-locked periodical missed, nothing for Restart */
+template <class Ticks, bool Locked>
+class MissedRuns
+{
+protected:
+  MissedRuns()
+    : m_missed(0)
+  {}
+  Ticks missedRuns() const
+  {
+    return m_missed;
+  }
+  void setMissedRuns(Ticks missed)
+  {
+    m_missed = missed;
+  }
+private:
+  Ticks m_missed;
+};
+
+template <class Ticks>
+class MissedRuns<Ticks, false>
+{
+protected:
+  Ticks missedRuns() const
+  {
+    return 0;
+  }
+  void setMissedRuns(Ticks)
+  {}
+};
+
+} // namespace detail
+
+} // namespace ew
+
+/** Calls a function object every ms milliseconds. FuncT is any nullable
+ * void(void) callable, see Periodical and InlinePeriodical, PhaseV one of
+ * PeriodicalModes::Phase.
+ */
+template <class FuncT, PeriodicalModes::Phase PhaseV = PeriodicalModes::Restart>
+class BasicPeriodical
+  : public PeriodicalModes
+  , private ew::detail::MissedRuns<unsigned long, PhaseV != PeriodicalModes::Restart>
 {
+  typedef ew::detail::MissedRuns<unsigned long, PhaseV != PeriodicalModes::Restart> Missed;
 public:
-  typedef std::function<void(void)> Func;
-  Periodical(unsigned long ms, Func &&func)
+  typedef FuncT Func;
+  typedef ew::MillisClock Clock;
+  BasicPeriodical(unsigned long ms, Func &&func)
     : m_ms(ms)
     , m_prev(0)
-    , m_func(func)
+    , m_func(static_cast<Func &&>(func))
   {}
   void operator()()
   {
@@ -44,18 +572,73 @@ public:
   void run()
   {
     if (m_func) {
-      auto now = millis();
-      if (now - m_prev > m_ms) {
-        m_prev = now;
+      run(millis());
+    }
+  }
+  /** run() at the time now sampled once for the loop pass, see Tick */
+  void run(unsigned long now)
+  {
+    if (m_func) {
+      unsigned long missed = 0;
+      if (due(now, m_prev, m_ms, PhaseV, missed)) {
+        Missed::setMissedRuns(missed);
         m_func();
       }
     }
   }
+  /** Milliseconds until the function is due, zero if it is due now and
+   * Never if there is nothing to call.
+   */
+  unsigned long remaining() const
+  {
+    return remaining(millis());
+  }
+  unsigned long remaining(unsigned long now) const
+  {
+    if (not m_func) {
+      return ew::TickTraits<unsigned long>::Never;
+    }
+    return PeriodicalModes::remaining(now - m_prev, m_ms, PhaseV);
+  }
+  static constexpr Phase getPhase()
+  {
+    return PhaseV;
+  }
+  /** Number of runs skipped (Skip) or still pending (Burst) when the
+   * function was called last.
+   */
+  unsigned long missed() const
+  {
+    return Missed::missedRuns();
+  }
+  void reset()
+  {
+    m_prev = millis();
+    Missed::setMissedRuns(0);
+  }
 private:
   unsigned long m_ms, m_prev;
   Func m_func;
 };
 
+/** Periodical which stores its function inline and therefore never
+ * touches the heap. Captures larger than Capacity bytes fail to compile.
+ *
+ * @code{.cpp}
+    InlinePeriodical<> blink(500, []() {
+      digitalWrite(LED_BUILTIN, not digitalRead(LED_BUILTIN));
+    });
+   @endcode
+ */
+template <size_t Capacity = 2 * sizeof(void *), PeriodicalModes::Phase PhaseV = PeriodicalModes::Restart>
+using InlinePeriodical = BasicPeriodical<ew::InlineFunction<Capacity>, PhaseV>;
+
+#if EW_HAVE_STD_FUNCTION
+typedef BasicPeriodical<std::function<void(void)> > Periodical;
+#else
+typedef InlinePeriodical<> Periodical;
+#endif
+
 /* Using CRTP to create derived classes and get rid of the function
  * object overhead.
  *
@@ -76,13 +659,30 @@ private:
       }
     };
    @endcode
+ *
+ * The period is given in ticks of ClockT, which are milliseconds by
+ * default. For a 5 kHz sampling task derive from
+ * PeriodicalBase<MyTask, ew::MicrosClock> and pass a period of 200.
+ *
+ * StatsT is an optional statistics policy, pass ew::TaskStats to record
+ * lateness and execution times of the task. PhaseV selects one of
+ * PeriodicalModes::Phase, e.g. PeriodicalModes::Skip for a drift-free
+ * schedule.
  */
-template <class T>
+template <class T, class ClockT = ew::MillisClock, class StatsT = ew::NoTaskStats,
+          PeriodicalModes::Phase PhaseV = PeriodicalModes::Restart>
 class PeriodicalBase
+  : public PeriodicalModes
+  , private StatsT
+  , private ew::detail::MissedRuns<typename ClockT::Ticks, PhaseV != PeriodicalModes::Restart>
 {
+  typedef ew::detail::MissedRuns<typename ClockT::Ticks, PhaseV != PeriodicalModes::Restart> Missed;
 public:
-  PeriodicalBase(unsigned long period_ms)
-    : m_period_ms(period_ms)
+  typedef ClockT Clock;
+  typedef typename Clock::Ticks Ticks;
+
+  PeriodicalBase(Ticks period)
+    : m_period(period)
     , m_prev(0)
   {}
   void operator()()
@@ -95,16 +695,44 @@ public:
    */
   void run()
   {
-    auto now = millis();
-    if (now - m_prev > m_period_ms) {
-      m_prev = now;
+    run(Clock::now());
+  }
+  /** run() at the time now sampled once for the loop pass, see Tick */
+  void run(Ticks now)
+  {
+    auto elapsed = now - m_prev;
+    Ticks missed = 0;
+    if (due(now, m_prev, m_period, PhaseV, missed)) {
+      Missed::setMissedRuns(missed);
+      auto start = StatsT::template enter<Clock>(elapsed - m_period - (PhaseV == Restart));
       static_cast<T*>(this)->task();
+      StatsT::template leave<Clock>(start, m_period);
     }
   }
+  StatsT &
+  stats()
+  {
+    return *this;
+  }
+  const StatsT &
+  stats() const
+  {
+    return *this;
+  }
+  void
+  setPeriod(Ticks period)
+  {
+    m_period = period;
+  }
+  Ticks
+  getPeriod() const
+  {
+    return m_period;
+  }
   void
   setPeriodMs(unsigned long period_ms)
   {
-    m_period_ms = period_ms;
+    setPeriod(Clock::fromMs(period_ms));
   }
   void
   setPeriodS(unsigned long period_s)
@@ -114,70 +742,118 @@ public:
   unsigned long
   getPeriodMs() const
   {
-    return m_period_ms;
+    return Clock::toMs(m_period);
   }
   unsigned long
   getPeriodS() const
   {
-    return m_period_ms / 1000UL;
+    return getPeriodMs() / 1000UL;
+  }
+  /** Ticks until the task is due, zero if it is due now. */
+  Ticks
+  remaining() const
+  {
+    return remaining(Clock::now());
+  }
+  Ticks
+  remaining(Ticks now) const
+  {
+    return PeriodicalModes::remaining(now - m_prev, m_period, PhaseV);
+  }
+  static constexpr Phase
+  getPhase()
+  {
+    return PhaseV;
+  }
+  /** Number of runs skipped (Skip) or still pending (Burst) when the
+   * task was called last.
+   */
+  Ticks
+  missed() const
+  {
+    return Missed::missedRuns();
+  }
+  /** Re-anchors the schedule to the current time */
+  void
+  reset()
+  {
+    m_prev = Clock::now();
+    Missed::setMissedRuns(0);
   }
 private:
-  unsigned long m_period_ms;
-  unsigned long m_prev;
+  Ticks m_period;
+  Ticks m_prev;
 };
 
 
-// TODO: implement a CRTP version of this
-// TODO: implement a callback version of this
-class Timer
+/** Timer modes, shared by all timer flavours */
+struct TimerModes
 {
-public:
-    typedef unsigned long ms_t;
     typedef enum {
         OneShot,
         Periodic,
     } Mode;
+};
+
+// CRTP version: see TimerBase below
+// Interrupt driven timers with callbacks: see HwTimerMux in EwHwTimer.h
+/** Timer running on ClockT, see Timer and MicroTimer. Timeouts are given
+ * in ticks of the clock.
+ */
+template <class ClockT>
+class BasicTimer
+    : public TimerModes
+{
+public:
+    typedef ClockT Clock;
+    typedef typename Clock::Ticks Ticks;
+    typedef Ticks ms_t;
 
     // todo: perhaps slave and master require different settings (e.g. timeout)
-    Timer(const ms_t & timeout = 0,
-          const Mode & mode = OneShot)
+    BasicTimer(const Ticks & timeout = 0,
+               const Mode & mode = OneShot)
         : m_mode(mode)
         , m_running(false)
-        , m_timeoutMs(timeout)
-        , m_timerLastMs(0)
+        , m_timeout(timeout)
+        , m_timerLast(0)
     { }
     bool expired()
     {
-        if (m_running and m_timeoutMs) {
-            auto now = millis();
-            if (now - m_timerLastMs > m_timeoutMs) {
-                if (m_mode == OneShot) {
-                    m_running = false;
-                } else {
-                    m_timerLastMs = now;
-                }
-                return true;
-            }
-        }
-        return false;
+        return m_running and m_timeout and fire(Clock::now());
+    }
+    /** expired() at the time now sampled once for the loop pass, see
+     * ew::Tick
+     */
+    bool expired(Ticks now)
+    {
+        return m_running and m_timeout and fire(now);
     }
     void start(void)
     {
-      start(m_timeoutMs);
+      start(m_timeout);
+    }
+    void start(Ticks timeout)
+    {
+        startAt(Clock::now(), timeout);
     }
-    void start(ms_t timeoutMs)
+    /** start() at the time now sampled once for the loop pass */
+    void startAt(Ticks now)
     {
-        m_timerLastMs = millis();
-        m_timeoutMs = timeoutMs;
+        startAt(now, m_timeout);
+    }
+    void startAt(Ticks now, Ticks timeout)
+    {
+        m_timerLast = now;
+        m_timeout = timeout;
         m_running = true;
     }
-    void setTimeout(ms_t timeoutMs)
+    void setTimeout(Ticks timeout)
     {
-        m_timeoutMs = timeoutMs;
+        m_timeout = timeout;
     }
-    ms_t getTimeout(void) const
+    Ticks getTimeout(void) const
     {
-        return m_timeoutMs;
+        return m_timeout;
     }
     void setMode(Mode mode)
     {
@@ -192,14 +868,336 @@ public:
     {
         return m_running;
     }
-
-private:
-    Mode m_mode;
+    /** Ticks until the timer expires, zero if it has expired and Never if
+     * it is stopped or has no timeout.
+     */
+    Ticks remaining(void) const
+    {
+        return remaining(Clock::now());
+    }
+    Ticks remaining(Ticks now) const
+    {
+        if (not m_running or not m_timeout) {
+            return ew::TickTraits<Ticks>::Never;
+        }
+        auto elapsed = now - m_timerLast;
+        return elapsed > m_timeout ? 0 : m_timeout - elapsed + 1;
+    }
+
+private:
+    bool fire(Ticks now)
+    {
+        if (now - m_timerLast > m_timeout) {
+            if (m_mode == OneShot) {
+                m_running = false;
+            } else {
+                m_timerLast = now;
+            }
+            return true;
+        }
+        return false;
+    }
+
+    /* a byte instead of the enum saves the padding */
+    uint8_t m_mode;
     bool m_running;
-    ms_t m_timeoutMs;
-    ms_t m_timerLastMs;
+    Ticks m_timeout;
+    Ticks m_timerLast;
+};
+
+/** Millisecond timer */
+typedef BasicTimer<ew::MillisClock> Timer;
+/** Microsecond timer, handles the micros() rollover after ~71 minutes */
+typedef BasicTimer<ew::MicrosClock> MicroTimer;
+
+/** Timer with the same interface and semantics as BasicTimer packing its
+ * mode and running flag into the two top bits of the timeout.
+ *
+ * With the default TimeoutT a CompactTimer takes two words instead of up
+ * to four, timeouts are limited to 2^30 - 1 ticks (~12 days on the
+ * millisecond clock). With a TimeoutT of uint16_t, see ShortTimer, it
+ * takes six bytes on 8-bit MCUs and timeouts up to MaxTimeout = 16383
+ * ticks. Longer timeouts are clamped to MaxTimeout.
+ */
+template <class ClockT, class TimeoutT = typename ClockT::Ticks>
+class BasicCompactTimer
+    : public TimerModes
+{
+public:
+    typedef ClockT Clock;
+    typedef typename Clock::Ticks Ticks;
+    static const TimeoutT MaxTimeout = static_cast<TimeoutT>(~TimeoutT(0)) >> 2;
+
+    BasicCompactTimer(Ticks timeout = 0, Mode mode = OneShot)
+        : m_timerLast(0)
+        , m_timeout(clamp(timeout))
+        , m_periodic(mode == Periodic)
+        , m_running(false)
+    { }
+    bool expired()
+    {
+        return m_running and m_timeout and fire(Clock::now());
+    }
+    /** expired() at the time now sampled once for the loop pass */
+    bool expired(Ticks now)
+    {
+        return m_running and m_timeout and fire(now);
+    }
+    void start(void)
+    {
+        startAt(Clock::now());
+    }
+    void start(Ticks timeout)
+    {
+        m_timeout = clamp(timeout);
+        start();
+    }
+    void startAt(Ticks now)
+    {
+        m_timerLast = now;
+        m_running = true;
+    }
+    void startAt(Ticks now, Ticks timeout)
+    {
+        m_timeout = clamp(timeout);
+        startAt(now);
+    }
+    /** Timeouts beyond MaxTimeout are clamped to it */
+    void setTimeout(Ticks timeout)
+    {
+        m_timeout = clamp(timeout);
+    }
+    Ticks getTimeout(void) const
+    {
+        return m_timeout;
+    }
+    void setMode(Mode mode)
+    {
+        m_periodic = mode == Periodic;
+    }
+    void stop(void)
+    {
+        m_running = false;
+    }
+    bool running(void) const
+    {
+        return m_running;
+    }
+    Ticks remaining(void) const
+    {
+        return remaining(Clock::now());
+    }
+    Ticks remaining(Ticks now) const
+    {
+        if (not m_running or not m_timeout) {
+            return ew::TickTraits<Ticks>::Never;
+        }
+        Ticks timeout = m_timeout;
+        auto elapsed = now - m_timerLast;
+        return elapsed > timeout ? 0 : timeout - elapsed + 1;
+    }
+
+private:
+    static TimeoutT clamp(Ticks timeout)
+    {
+        return timeout > MaxTimeout ? MaxTimeout : static_cast<TimeoutT>(timeout);
+    }
+    bool fire(Ticks now)
+    {
+        Ticks timeout = m_timeout;
+        if (now - m_timerLast > timeout) {
+            if (m_periodic) {
+                m_timerLast = now;
+            } else {
+                m_running = false;
+            }
+            return true;
+        }
+        return false;
+    }
+
+    Ticks m_timerLast;
+    TimeoutT m_timeout : sizeof(TimeoutT) * 8 - 2;
+    TimeoutT m_periodic : 1;
+    TimeoutT m_running : 1;
 };
 
+template <class ClockT, class TimeoutT>
+const TimeoutT BasicCompactTimer<ClockT, TimeoutT>::MaxTimeout;
+
+/** Millisecond timer in two words */
+typedef BasicCompactTimer<ew::MillisClock> CompactTimer;
+/** Millisecond timer for timeouts up to 16.3 s */
+typedef BasicCompactTimer<ew::MillisClock, uint16_t> ShortTimer;
+
+namespace ew {
+namespace detail {
+
+/** Timeout of a TimerBase, a member only if it is not known at compile
+ * time.
+ */
+template <class ClockT, unsigned long TimeoutMs>
+struct TimerTimeout
+{
+  typename ClockT::Ticks timeout() const
+  {
+    return ClockT::fromMs(TimeoutMs);
+  }
+};
+template <class ClockT>
+struct TimerTimeout<ClockT, 0>
+{
+  typename ClockT::Ticks timeout() const
+  {
+    return m_timeout;
+  }
+  typename ClockT::Ticks m_timeout = 0;
+};
+
+} // namespace detail
+} // namespace ew
+
+/** CRTP timer calling onExpired() of your derived class. Mode and
+ * optionally the timeout are fixed at compile time, which removes the
+ * runtime checks from expired() and their storage from the timer. With a
+ * TimeoutMs given a timer is just a timestamp and a flag.
+ *
+ * @code{.cpp}
+    class Blink
+      : public TimerBase<Blink, TimerModes::Periodic, 500>
+    {
+    public:
+      void onExpired()
+      {
+        digitalWrite(LED_BUILTIN, not digitalRead(LED_BUILTIN));
+      }
+    };
+    Blink blink;
+    ...
+    blink.start();
+    ...
+    blink.run();
+   @endcode
+ *
+ * Without TimeoutMs the timeout is passed to the constructor or start() in
+ * ticks of ClockT, a timeout of zero never expires as with Timer. Call
+ * run() from the main loop, or add it to an ew::Scheduler.
+ */
+template <class T,
+          TimerModes::Mode ModeV = TimerModes::OneShot,
+          unsigned long TimeoutMs = 0,
+          class ClockT = ew::MillisClock>
+class TimerBase
+  : public TimerModes
+  , private ew::detail::TimerTimeout<ClockT, TimeoutMs>
+{
+  typedef ew::detail::TimerTimeout<ClockT, TimeoutMs> Timeout;
+public:
+  typedef ClockT Clock;
+  typedef typename Clock::Ticks Ticks;
+  static const Mode TimerMode = ModeV;
+
+  TimerBase()
+    : m_timerLast(0)
+    , m_running(false)
+  {}
+  explicit TimerBase(Ticks timeout)
+    : m_timerLast(0)
+    , m_running(false)
+  {
+    static_assert(TimeoutMs == 0, "the timeout is fixed at compile time");
+    Timeout::m_timeout = timeout;
+  }
+  /** Calls onExpired() if the timer expired. Can be overridden. */
+  void run()
+  {
+    if (expired()) {
+      static_cast<T*>(this)->onExpired();
+    }
+  }
+  /** run() at the time now sampled once for the loop pass, see Tick */
+  void run(Ticks now)
+  {
+    if (expired(now)) {
+      static_cast<T*>(this)->onExpired();
+    }
+  }
+  bool expired()
+  {
+    if (not m_running or (TimeoutMs == 0 and not getTimeout())) {
+      return false;
+    }
+    return expired(Clock::now());
+  }
+  bool expired(Ticks now)
+  {
+    if (not m_running or (TimeoutMs == 0 and not getTimeout())) {
+      return false;
+    }
+    if (now - m_timerLast <= getTimeout()) {
+      return false;
+    }
+    if (ModeV == OneShot) {
+      m_running = false;
+    } else {
+      m_timerLast = now;
+    }
+    return true;
+  }
+  void start()
+  {
+    startAt(Clock::now());
+  }
+  void start(Ticks timeout)
+  {
+    setTimeout(timeout);
+    start();
+  }
+  void startAt(Ticks now)
+  {
+    m_timerLast = now;
+    m_running = true;
+  }
+  void stop()
+  {
+    m_running = false;
+  }
+  bool running() const
+  {
+    return m_running;
+  }
+  void setTimeout(Ticks timeout)
+  {
+    static_assert(TimeoutMs == 0, "the timeout is fixed at compile time");
+    Timeout::m_timeout = timeout;
+  }
+  Ticks getTimeout() const
+  {
+    return Timeout::timeout();
+  }
+  /** Ticks until the timer expires, zero if it has expired and Never if
+   * it is stopped or has no timeout.
+   */
+  Ticks remaining() const
+  {
+    return remaining(Clock::now());
+  }
+  Ticks remaining(Ticks now) const
+  {
+    if (not m_running or not getTimeout()) {
+      return ew::TickTraits<Ticks>::Never;
+    }
+    auto elapsed = now - m_timerLast;
+    return elapsed > getTimeout() ? 0 : getTimeout() - elapsed + 1;
+  }
+private:
+  Ticks m_timerLast;
+  bool m_running;
+};
+
+template <class T, TimerModes::Mode ModeV, unsigned long TimeoutMs, class ClockT>
+const TimerModes::Mode TimerBase<T, ModeV, TimeoutMs, ClockT>::TimerMode;
+
 /** Placing the print functions into a separate namespace.
  * This way anyone can decide to swap it in with
  *
@@ -213,6 +1211,305 @@ namespace ew {
 
 template<class T> inline Print &operator <<(Print &obj, T arg) { obj.print(arg); return obj; }
 
+namespace detail {
+
+/* Division-free integer to text conversion. Divisions by constants are
+ * replaced by multiplications with their reciprocal (exact over the stated
+ * input ranges) and digits are emitted in pairs from a lookup table.
+ */
+
+inline const char *
+digitPairs()
+{
+  static const char pairs[201] PROGMEM =
+    "00010203040506070809"
+    "10111213141516171819"
+    "20212223242526272829"
+    "30313233343536373839"
+    "40414243444546474849"
+    "50515253545556575859"
+    "60616263646566676869"
+    "70717273747576777879"
+    "80818283848586878889"
+    "90919293949596979899";
+  return pairs;
+}
+
+/** Writes the two digits of v < 100 to p */
+inline char *
+putPair(char *p, uint8_t v)
+{
+  const char *pair = digitPairs() + 2 * v;
+  p[0] = pgm_read_byte(pair);
+  p[1] = pgm_read_byte(pair + 1);
+  return p + 2;
+}
+
+/** Writes v < 100 without leading zero */
+inline char *
+putSmall(char *p, uint8_t v)
+{
+  if (v < 10) {
+    *p++ = '0' + v;
+    return p;
+  }
+  return putPair(p, v);
+}
+
+inline uint32_t
+div100(uint32_t v)
+{
+  if (v < 43699UL) {
+    return (static_cast<uint32_t>(static_cast<uint16_t>(v)) * 5243U) >> 19;
+  }
+  return static_cast<uint32_t>((static_cast<uint64_t>(v) * 1374389535ULL) >> 37);
+}
+
+/** Writes the decimal digits of v backwards so they end at end and
+ * returns a pointer to the first digit.
+ */
+inline char *
+utoaRev(uint32_t v, char *end)
+{
+  while (v >= 100) {
+    uint32_t q = div100(v);
+    end -= 2;
+    putPair(end, v - q * 100);
+    v = q;
+  }
+  if (v >= 10) {
+    end -= 2;
+    putPair(end, v);
+  } else {
+    *--end = '0' + v;
+  }
+  return end;
+}
+
+inline char *
+utoaRev(uint64_t v, char *end)
+{
+  while (v > 0xFFFFFFFFULL) {
+    uint64_t q = v / 100000000ULL;
+    uint32_t r = static_cast<uint32_t>(v - q * 100000000ULL);
+    for (uint8_t i = 0; i < 4; i++) {
+      uint32_t q2 = div100(r);
+      end -= 2;
+      putPair(end, r - q2 * 100);
+      r = q2;
+    }
+    v = q;
+  }
+  return utoaRev(static_cast<uint32_t>(v), end);
+}
+
+template <size_t Size> struct UInt32Or64    { typedef uint32_t type; };
+template <> struct UInt32Or64<8>            { typedef uint64_t type; };
+
+template <class U>
+inline Print &
+printUnsigned(Print &prt, U v, bool neg = false)
+{
+  char buf[21];
+  char *end = buf + sizeof(buf);
+  char *p = utoaRev(static_cast<typename UInt32Or64<sizeof(U)>::type>(v), end);
+  if (neg) {
+    *--p = '-';
+  }
+  prt.write(reinterpret_cast<const uint8_t*>(p), end - p);
+  return prt;
+}
+
+template <class S>
+inline Print &
+printSigned(Print &prt, S v)
+{
+  typedef typename UInt32Or64<sizeof(S)>::type U;
+  return v < 0 ? printUnsigned(prt, U(0) - static_cast<U>(v), true)
+               : printUnsigned(prt, static_cast<U>(v));
+}
+
+/** vsnprintf() reading the format straight out of flash */
+inline int
+vsnprintfFlash(char *buf, size_t len, const __FlashStringHelper *fmt, va_list args)
+{
+#if defined(__AVR__) || defined(ESP8266) || defined(vsnprintf_P)
+  return vsnprintf_P(buf, len, reinterpret_cast<PGM_P>(fmt), args);
+#else
+  return vsnprintf(buf, len, reinterpret_cast<const char *>(fmt), args);
+#endif
+}
+
+} // namespace detail
+
+/* Integers are rendered by the conversion kernels above instead of going
+ * through Print::print() and its division loop.
+ */
+inline Print &operator <<(Print &obj, unsigned char arg)      { return detail::printUnsigned(obj, arg); }
+inline Print &operator <<(Print &obj, unsigned short arg)     { return detail::printUnsigned(obj, arg); }
+inline Print &operator <<(Print &obj, unsigned int arg)       { return detail::printUnsigned(obj, arg); }
+inline Print &operator <<(Print &obj, unsigned long arg)      { return detail::printUnsigned(obj, arg); }
+inline Print &operator <<(Print &obj, unsigned long long arg) { return detail::printUnsigned(obj, arg); }
+inline Print &operator <<(Print &obj, short arg)              { return detail::printSigned(obj, arg); }
+inline Print &operator <<(Print &obj, int arg)                { return detail::printSigned(obj, arg); }
+inline Print &operator <<(Print &obj, long arg)               { return detail::printSigned(obj, arg); }
+inline Print &operator <<(Print &obj, long long arg)          { return detail::printSigned(obj, arg); }
+
+/** Fixed-size string living on the stack or in a global without ever
+ * touching the heap. N is the buffer size including the terminating zero.
+ *
+ * Everything printed to it, appended or formatted into it is appended up
+ * to its capacity. Whatever does not fit is dropped and flagged by
+ * truncated() until the next clear() or assignment.
+ *
+ * @code{.cpp}
+    ew::FixedString<32> line;
+    prtFmt(line, "T=%d.%dC", t / 10, t % 10);
+    line.print(" ok");
+    Serial.println(line.c_str());
+   @endcode
+ */
+template <size_t N>
+class FixedString
+  : public Print
+{
+  static_assert(N > 0, "FixedString needs room for the terminating zero");
+public:
+  FixedString()
+  {
+    clear();
+  }
+  FixedString(const char *str)
+  {
+    clear();
+    append(str);
+  }
+  FixedString &operator=(const char *str)
+  {
+    clear();
+    return append(str);
+  }
+  FixedString &operator+=(const char *str)
+  {
+    return append(str);
+  }
+  FixedString &operator+=(char c)
+  {
+    write(static_cast<uint8_t>(c));
+    return *this;
+  }
+  FixedString &append(const char *str)
+  {
+    if (str) {
+      write(reinterpret_cast<const uint8_t*>(str), strlen(str));
+    }
+    return *this;
+  }
+  /** Appends printf-style formatted text */
+  FixedString &appendFmt(const char *fmt, ...)
+    __attribute__ ((format (printf, 2, 3)))
+  {
+    va_list args;
+    va_start(args, fmt);
+    vappendFmt(fmt, args);
+    va_end(args);
+    return *this;
+  }
+  /** Appends printf-style formatted text, the format in flash */
+  FixedString &appendFmt(const __FlashStringHelper *fmt, ...)
+  {
+    va_list args;
+    va_start(args, fmt);
+    vappendFmt(fmt, args);
+    va_end(args);
+    return *this;
+  }
+  FixedString &vappendFmt(const char *fmt, va_list args)
+  {
+    return appended(vsnprintf(m_buf + m_len, N - m_len, fmt, args));
+  }
+  FixedString &vappendFmt(const __FlashStringHelper *fmt, va_list args)
+  {
+    return appended(detail::vsnprintfFlash(m_buf + m_len, N - m_len, fmt, args));
+  }
+
+  size_t write(uint8_t c) override
+  {
+    if (m_len >= N - 1) {
+      m_truncated = true;
+      return 0;
+    }
+    m_buf[m_len++] = c;
+    m_buf[m_len] = '\0';
+    return 1;
+  }
+  size_t write(const uint8_t *buf, size_t len) override
+  {
+    size_t room = N - 1 - m_len;
+    if (len > room) {
+      len = room;
+      m_truncated = true;
+    }
+    memcpy(m_buf + m_len, buf, len);
+    m_len += len;
+    m_buf[m_len] = '\0';
+    return len;
+  }
+  using Print::write;
+
+  void clear()
+  {
+    m_len = 0;
+    m_buf[0] = '\0';
+    m_truncated = false;
+  }
+  const char *c_str() const
+  {
+    return m_buf;
+  }
+  size_t length() const
+  {
+    return m_len;
+  }
+  static constexpr size_t capacity()
+  {
+    return N - 1;
+  }
+  bool truncated() const
+  {
+    return m_truncated;
+  }
+  char operator[](size_t i) const
+  {
+    return m_buf[i];
+  }
+private:
+  /** Accounts for n characters vsnprintf() wanted to append */
+  FixedString &appended(int n)
+  {
+    if (n < 0) {
+      m_buf[m_len] = '\0';
+    } else if (static_cast<size_t>(n) >= N - m_len) {
+      m_len = N - 1;
+      m_truncated = true;
+    } else {
+      m_len += n;
+    }
+    return *this;
+  }
+
+  char m_buf[N];
+  size_t m_len;
+  bool m_truncated;
+};
+
+template <size_t N>
+inline Print &operator <<(Print &obj, const FixedString<N> &str)
+{
+  obj.write(str.c_str(), str.length());
+  return obj;
+}
+
 const char*
 prtFmt(char* buf, size_t buflen, const char *fmt, ... )
   __attribute__ ((format (printf, 3, 4)));
@@ -232,18 +1529,25 @@ Print&
 prtFmt(Print& prt, const char *fmt, ...)
   __attribute__ ((format (printf, 2, 3)));
 
+/** Formats into a stack buffer of BufSize bytes and prints it in one go.
+ * Output exceeding the buffer is truncated. See streamFmt() in
+ * EwStreamFmt.h for formatting of arbitrary length.
+ */
 template <size_t BufSize>
 inline Print&
 prtFmt(Print& prt, const char *fmt, ...)
 {
-  char buf[BufSize]{0};
+  char buf[BufSize];
 
   va_list args;
   va_start(args, fmt);
-  vsnprintf(buf, BufSize, fmt, args);
+  int n = vsnprintf(buf, BufSize, fmt, args);
   va_end(args);
 
-  prt.print(buf);
+  if (n > 0) {
+    prt.write(reinterpret_cast<const uint8_t*>(buf),
+              static_cast<size_t>(n) < BufSize ? n : BufSize - 1);
+  }
   return prt;
 }
 
@@ -256,17 +1560,98 @@ template <size_t BufSize>
 inline String&
 prtFmt(String& str, const char *fmt, ...)
 {
-  char buf[BufSize]{0};
+  char buf[BufSize];
 
   va_list args;
   va_start(args, fmt);
-  vsnprintf(buf, BufSize, fmt, args);
+  if (vsnprintf(buf, BufSize, fmt, args) < 0) {
+    buf[0] = '\0';
+  }
   va_end(args);
 
   str = buf;
   return str;
 }
 
+/** Formats straight into the FixedString, replacing its contents */
+template <size_t N>
+inline FixedString<N>&
+prtFmt(FixedString<N>& str, const char *fmt, ...)
+  __attribute__ ((format (printf, 2, 3)));
+
+template <size_t N>
+inline FixedString<N>&
+prtFmt(FixedString<N>& str, const char *fmt, ...)
+{
+  va_list args;
+  va_start(args, fmt);
+  str.clear();
+  str.vappendFmt(fmt, args);
+  va_end(args);
+  return str;
+}
+
+/* The same with the format in flash, prtFmt(Serial, F("T=%d"), t), which
+ * on AVR keeps the format literal out of SRAM. The compiler can't check
+ * these formats against the arguments.
+ */
+inline const char*
+prtFmt(char* buf, size_t buflen, const __FlashStringHelper *fmt, ... )
+{
+  va_list args;
+  va_start (args, fmt );
+  detail::vsnprintfFlash(buf, buflen, fmt, args);
+  va_end (args);
+  return buf;
+}
+
+template <size_t BufSize=64>
+inline Print&
+prtFmt(Print& prt, const __FlashStringHelper *fmt, ...)
+{
+  char buf[BufSize];
+
+  va_list args;
+  va_start(args, fmt);
+  int n = detail::vsnprintfFlash(buf, BufSize, fmt, args);
+  va_end(args);
+
+  if (n > 0) {
+    prt.write(reinterpret_cast<const uint8_t*>(buf),
+              static_cast<size_t>(n) < BufSize ? n : BufSize - 1);
+  }
+  return prt;
+}
+
+template <size_t BufSize=64>
+inline String&
+prtFmt(String& str, const __FlashStringHelper *fmt, ...)
+{
+  char buf[BufSize];
+
+  va_list args;
+  va_start(args, fmt);
+  if (detail::vsnprintfFlash(buf, BufSize, fmt, args) < 0) {
+    buf[0] = '\0';
+  }
+  va_end(args);
+
+  str = buf;
+  return str;
+}
+
+template <size_t N>
+inline FixedString<N>&
+prtFmt(FixedString<N>& str, const __FlashStringHelper *fmt, ...)
+{
+  va_list args;
+  va_start(args, fmt);
+  str.clear();
+  str.vappendFmt(fmt, args);
+  va_end(args);
+  return str;
+}
+
 
 const unsigned long SECS_PER_MIN  (60UL);
 const unsigned long SECS_PER_HOUR (3600UL);
@@ -299,19 +1684,92 @@ numberOfDays(unsigned long seconds)
   return seconds / SECS_PER_DAY;
 }
 
-inline String &
-fmtElapsed(String &str,
-           unsigned long seconds,
-           bool all = false,
-           const char *fmts = "%lus",
-           const char *fmtm = "%lum %02lus",
-           const char *fmth = "%luh %02lum %02lus",
-           const char *fmtd = "%lud %02luh %02lum %02lus")
+namespace detail {
+
+/** Splits seconds into days, hours, minutes and seconds by reciprocal
+ * multiplication, see numberOfDays() and friends for the plain version.
+ */
+inline void
+splitElapsed(unsigned long seconds, unsigned long &d, uint8_t &h, uint8_t &m, uint8_t &s)
+{
+  uint32_t r;
+  if (sizeof(seconds) == 4 or seconds <= 0xFFFFFFFFUL) {
+    uint32_t v = seconds;
+    d = static_cast<uint32_t>((static_cast<uint64_t>(v) * 3257812231ULL) >> 48);
+    r = v - d * SECS_PER_DAY;
+  } else {
+    d = seconds / SECS_PER_DAY;
+    r = seconds - d * SECS_PER_DAY;
+  }
+  h = (r * 37283UL) >> 27;
+  r -= h * 3600U;
+  m = (r * 4370UL) >> 18;
+  s = r - m * 60U;
+}
+
+/** The same for 64-bit seconds, up to 2^32 days */
+inline void
+splitElapsed(unsigned long long seconds, unsigned long &d, uint8_t &h, uint8_t &m, uint8_t &s)
 {
-  auto d = numberOfDays(seconds);
-  auto h = numberOfHours(seconds);
-  auto m = numberOfMinutes(seconds);
-  auto s = numberOfSeconds(seconds);
+  if (seconds <= 0xFFFFFFFFULL) {
+    splitElapsed(static_cast<unsigned long>(seconds), d, h, m, s);
+    return;
+  }
+  unsigned long long days = seconds / SECS_PER_DAY;
+  splitElapsed(static_cast<unsigned long>(seconds - days * SECS_PER_DAY), d, h, m, s);
+  d = days;
+}
+
+/** Renders the default fmtElapsed() formats into buf, which must hold at
+ * least 32 characters, and returns the length.
+ */
+inline size_t
+putElapsed(char *buf, unsigned long d, uint8_t h, uint8_t m, uint8_t s, bool all)
+{
+  char *p = buf;
+  if (d or all) {
+    char digits[20];
+    char *end = digits + sizeof(digits);
+    char *q = utoaRev(static_cast<UInt32Or64<sizeof(d)>::type>(d), end);
+    while (q != end) {
+      *p++ = *q++;
+    }
+    *p++ = 'd';
+    *p++ = ' ';
+    p = putPair(p, h);
+  } else if (h) {
+    p = putSmall(p, h);
+  }
+  if (d or all or h) {
+    *p++ = 'h';
+    *p++ = ' ';
+    p = putPair(p, m);
+  } else if (m) {
+    p = putSmall(p, m);
+  }
+  if (d or all or h or m) {
+    *p++ = 'm';
+    *p++ = ' ';
+    p = putPair(p, s);
+  } else {
+    p = putSmall(p, s);
+  }
+  *p++ = 's';
+  *p = '\0';
+  return p - buf;
+}
+
+} // namespace detail
+
+namespace detail {
+
+template <class S, class SecT, class FmtT>
+inline S &
+fmtElapsed(S &str, SecT seconds, bool all, FmtT fmts, FmtT fmtm, FmtT fmth, FmtT fmtd)
+{
+  unsigned long d;
+  uint8_t h, m, s;
+  detail::splitElapsed(seconds, d, h, m, s);
 
   // note: in case some sort of flagging is
   // implemented:
@@ -320,15 +1778,115 @@ fmtElapsed(String &str,
   //  multiply the d with number of h per d
   //  ... and so on for "up to m"
 
+  FmtT fmt = (d or all) ? fmtd : h ? fmth : m ? fmtm : fmts;
+  if (not fmt) {
+    char buf[32];
+    detail::putElapsed(buf, d, h, m, s, all);
+    str = buf;
+    return str;
+  }
+
+  unsigned long lh = h, lm = m, ls = s;
   if (d or all) {
-    return prtFmt(str, fmtd, d, h, m, s);
+    return prtFmt(str, fmt, d, lh, lm, ls);
   } else if (h) {
-    return prtFmt(str, fmth, h, m, s);
+    return prtFmt(str, fmt, lh, lm, ls);
   } else if (m) {
-    return prtFmt(str, fmtm, m, s);
+    return prtFmt(str, fmt, lm, ls);
   } else {
-    return prtFmt(str, fmts, s);
+    return prtFmt(str, fmt, ls);
   }
 }
 
+} // namespace detail
+
+/** Formats an elapsed time into str, which is either a String or a
+ * FixedString.
+ *
+ * Formats left at nullptr use the built-in ones ("%lus", "%lum %02lus",
+ * "%luh %02lum %02lus" and "%lud %02luh %02lum %02lus") which are rendered
+ * without going through vsnprintf and don't take any SRAM for strings.
+ */
+template <class S>
+inline S &
+fmtElapsed(S &str,
+           unsigned long seconds,
+           bool all = false,
+           const char *fmts = nullptr,
+           const char *fmtm = nullptr,
+           const char *fmth = nullptr,
+           const char *fmtd = nullptr)
+{
+  return detail::fmtElapsed(str, seconds, all, fmts, fmtm, fmth, fmtd);
+}
+
+/** The same with the formats in flash:
+ *
+ * @code{.cpp}
+    fmtElapsed(str, secs, false, F("%lu s"), F("%lu min"), F("%lu h"), F("%lu d"));
+   @endcode
+ */
+template <class S>
+inline S &
+fmtElapsed(S &str,
+           unsigned long seconds,
+           bool all,
+           const __FlashStringHelper *fmts,
+           const __FlashStringHelper *fmtm = nullptr,
+           const __FlashStringHelper *fmth = nullptr,
+           const __FlashStringHelper *fmtd = nullptr)
+{
+  return detail::fmtElapsed(str, seconds, all, fmts, fmtm, fmth, fmtd);
+}
+
+/** fmtElapsed() of 64-bit seconds, the uptime from Millis64Clock in
+ * EwClock64.h for instance
+ */
+template <class S, class U>
+inline typename detail::EnableIf<detail::IsSame<U, unsigned long long>::value, S &>::type
+fmtElapsed(S &str,
+           U seconds,
+           bool all = false,
+           const char *fmts = nullptr,
+           const char *fmtm = nullptr,
+           const char *fmth = nullptr,
+           const char *fmtd = nullptr)
+{
+  return detail::fmtElapsed(str, seconds, all, fmts, fmtm, fmth, fmtd);
+}
+
+namespace detail {
+
+template <class SecT>
+inline Print &
+prtElapsed(Print &prt, SecT seconds, bool all)
+{
+  unsigned long d;
+  uint8_t h, m, s;
+  detail::splitElapsed(seconds, d, h, m, s);
+  char buf[32];
+  size_t len = detail::putElapsed(buf, d, h, m, s, all);
+  prt.write(reinterpret_cast<const uint8_t*>(buf), len);
+  return prt;
+}
+
+} // namespace detail
+
+/** Prints an elapsed time in the built-in fmtElapsed() format straight
+ * to prt.
+ */
+inline Print &
+prtElapsed(Print &prt, unsigned long seconds, bool all = false)
+{
+  return detail::prtElapsed(prt, seconds, all);
+}
+
+/** prtElapsed() of 64-bit seconds */
+template <class U>
+inline typename detail::EnableIf<detail::IsSame<U, unsigned long long>::value, Print &>::type
+prtElapsed(Print &prt, U seconds, bool all = false)
+{
+  return detail::prtElapsed(prt, seconds, all);
+}
+
 } // namespace ew